@@ -0,0 +1,94 @@
+// Splits the raw ESP32 byte stream into text lines (JSON protocol, console
+// output) and binary log frames, and formats those frames on the host.
+//
+// Frame layout (see main/app_log.h): [0x1E] [len] [event id:2] [timestamp ms:4] [args...]
+// Format strings live in build/log_strings.json, generated by the firmware build.
+const fs = require('fs');
+const path = require('path');
+
+const FRAME_MARKER = 0x1E;
+const NEWLINE = 0x0A;
+const DEFAULT_LOG_TABLE = path.resolve(__dirname, '../../../build/log_strings.json');
+
+function createDeviceStreamSplitter({ onLine, onFrame }) {
+    let lineBytes = [];
+    let frameBytes = null;
+    let frameLength = -1;
+
+    return (chunk) => {
+        for (const byte of chunk) {
+            if (frameBytes) {
+                if (frameLength < 0) {
+                    frameLength = byte;
+                } else {
+                    frameBytes.push(byte);
+                }
+                if (frameBytes.length === frameLength) {
+                    onFrame(Buffer.from(frameBytes));
+                    frameBytes = null;
+                    frameLength = -1;
+                }
+            } else if (byte === FRAME_MARKER) {
+                frameBytes = [];
+            } else if (byte === NEWLINE) {
+                onLine(Buffer.from(lineBytes).toString('utf8'));
+                lineBytes = [];
+            } else {
+                lineBytes.push(byte);
+            }
+        }
+    };
+}
+
+function loadLogTable(file = process.env.ESP32_LOG_TABLE || DEFAULT_LOG_TABLE) {
+    try {
+        return JSON.parse(fs.readFileSync(file, 'utf8'));
+    } catch (error) {
+        console.log(`⚠️ No log string table at ${file} (${error.message}); binary logs will show raw event IDs`);
+        return null;
+    }
+}
+
+function formatLogFrame(table, frame) {
+    if (frame.length < 6) {
+        return { id: -1, level: 'W', timestamp: 0, message: '<truncated log frame>' };
+    }
+
+    const id = frame.readUInt16LE(0);
+    const timestamp = frame.readUInt32LE(2);
+    const event = table && table.events[id];
+
+    if (!event) {
+        return { id, level: 'I', timestamp, message: `<log event ${id}: ${frame.subarray(6).toString('hex')}>` };
+    }
+
+    // Decode raw arguments using the event's type signature
+    const args = [];
+    let pos = 6;
+    for (const type of event.args) {
+        if (type === 's') {
+            if (pos >= frame.length) break;
+            const length = frame[pos++];
+            args.push(frame.toString('utf8', pos, pos + length));
+            pos += length;
+        } else {
+            if (pos + 4 > frame.length) break;
+            args.push(type === 'u' ? frame.readUInt32LE(pos) : frame.readInt32LE(pos));
+            pos += 4;
+        }
+    }
+
+    let next = 0;
+    const message = event.format.replace(/%[-+ 0#]*\d*(?:\.\d+)?(?:l|ll|h)?([diuxXs%])/g, (_, conv) => {
+        if (conv === '%') return '%';
+        const value = args[next++];
+        if (value === undefined) return '?';
+        if (conv === 'x') return (value >>> 0).toString(16);
+        if (conv === 'X') return (value >>> 0).toString(16).toUpperCase();
+        return String(value);
+    });
+
+    return { id, name: event.name, level: event.level, timestamp, message };
+}
+
+module.exports = { createDeviceStreamSplitter, loadLogTable, formatLogFrame };
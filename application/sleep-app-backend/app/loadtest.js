@@ -0,0 +1,94 @@
+// Protocol load test over the firmware's TCP transport.
+// Usage: ESP32_TCP=host:port node app/loadtest.js [count] [window]
+//   count  - commands to send (default 1000)
+//   window - commands kept in flight (default 1 = pure round-trip latency)
+// The first command resets the firmware's timing stats; the sensor_jitter and
+// command_latency the device measured during the run are printed at the end.
+const net = require('net');
+const { createDeviceStreamSplitter } = require('./deviceStream');
+
+const [host, port] = (process.env.ESP32_TCP || 'localhost:3333').split(':');
+const COUNT = Number(process.argv[2]) || 1000;
+const WINDOW = Number(process.argv[3]) || 1;
+const COMMAND = JSON.stringify({ command: 'get_timing' }) + '\n';
+const RESET_COMMAND = JSON.stringify({ command: 'get_timing', reset: true }) + '\n';
+
+const socket = net.connect({ host, port: Number(port) || 3333 });
+socket.setNoDelay(true);
+
+let sent = 0;
+let received = 0;
+let bytesIn = 0;
+const sendTimes = [];
+const latencies = [];
+let startTime = 0;
+let deviceTiming = null;
+
+function sendNext() {
+    while (sent < COUNT && sent - received < WINDOW) {
+        sendTimes.push(process.hrtime.bigint());
+        socket.write(sent === 0 ? RESET_COMMAND : COMMAND);
+        sent++;
+    }
+}
+
+function handleMessage(text) {
+    let msg;
+    try {
+        msg = JSON.parse(text);
+    } catch {
+        return;
+    }
+    // Every get_timing reply is preceded by the stats, so the last one covers the run
+    if (msg.type === 'timing_stats') {
+        deviceTiming = msg.timing;
+        return;
+    }
+    if (msg.type !== 'command_response' || msg.command !== 'get_timing') return;
+
+    const t0 = sendTimes[received++];
+    latencies.push(Number(process.hrtime.bigint() - t0) / 1e3);
+
+    if (received === COUNT) {
+        report();
+        socket.end();
+        return;
+    }
+    sendNext();
+}
+
+function report() {
+    const elapsed = Number(process.hrtime.bigint() - startTime) / 1e9;
+    latencies.sort((a, b) => a - b);
+    const pct = (p) => latencies[Math.min(latencies.length - 1, Math.floor(latencies.length * p))].toFixed(0);
+
+    console.log(`📊 ${COUNT} commands, window ${WINDOW}, ${elapsed.toFixed(2)} s`);
+    console.log(`   throughput: ${(COUNT / elapsed).toFixed(1)} cmd/s, ${(bytesIn / elapsed / 1024).toFixed(1)} KiB/s in`);
+    console.log(`   latency µs: p50 ${pct(0.5)}  p90 ${pct(0.9)}  p99 ${pct(0.99)}  max ${pct(1)}`);
+
+    if (deviceTiming) {
+        for (const name of ['sensor_jitter', 'command_latency']) {
+            const t = deviceTiming[name];
+            console.log(`   device ${name} µs: ${t.samples} samples, min ${t.min_us}  max ${t.max_us}  mean_abs ${t.mean_abs_us}  max_abs ${t.max_abs_us}`);
+        }
+    }
+}
+
+socket.on('connect', () => {
+    console.log(`🔌 Connected to tcp://${host}:${port}`);
+    startTime = process.hrtime.bigint();
+    sendNext();
+});
+
+// One JSON message per line; binary log frames are skipped
+const split = createDeviceStreamSplitter({ onLine: handleMessage, onFrame: () => {} });
+
+socket.on('data', (chunk) => {
+    bytesIn += chunk.length;
+    split(chunk);
+});
+
+socket.on('error', (err) => {
+    console.error('❌ Load test failed:', err.message);
+    process.exit(1);
+});
@@ -1,11 +1,15 @@
 const { SerialPort } = require('serialport');
-const { ReadlineParser } = require('@serialport/parser-readline');
 const WebSocket = require('ws');
 const express = require('express');
 const cors = require('cors');
+const net = require('net');
+const { createDeviceStreamSplitter, loadLogTable, formatLogFrame } = require('./deviceStream');
 
 const HTTP_PORT = 3001;
 const WS_PORT = 3002;
+// Set ESP32_TCP=host:port to talk to firmware built with the TCP transport
+// instead of scanning for a serial port
+const ESP32_TCP = process.env.ESP32_TCP;
 
 // Express server for HTTP endpoints
 const app = express();
@@ -16,8 +20,8 @@ app.use(express.json());
 const wss = new WebSocket.Server({ port: WS_PORT });
 
 let esp32Port = null;
-let esp32Parser = null;
 let connectedClients = new Set();
+const logTable = loadLogTable();
 
 // Utility functions
 function logError(context, error) {
@@ -69,8 +73,44 @@ async function findESP32() {
     }
 }
 
+// Connect to ESP32 over the firmware's TCP transport
+function connectESP32Tcp() {
+    const [host, port] = ESP32_TCP.split(':');
+
+    return new Promise((resolve) => {
+        const socket = net.connect({ host: host || 'localhost', port: Number(port) || 3333 });
+
+        socket.once('connect', () => {
+            socket.setNoDelay(true);
+            logSuccess(`ESP32 connected on tcp://${host}:${port}`);
+
+            // Same surface the serial path uses: isOpen, write(msg, cb), drain(cb)
+            esp32Port = {
+                get isOpen() { return !socket.destroyed; },
+                write: (message, cb) => socket.write(message, cb),
+                drain: (cb) => cb()
+            };
+            setupESP32DataHandlers(socket);
+
+            socket.on('close', () => {
+                console.log('🔌 ESP32 disconnected');
+                reconnectESP32();
+            });
+
+            resolve(true);
+        });
+
+        socket.on('error', (err) => {
+            logError('ESP32 TCP connection error', err);
+            if (!esp32Port) resolve(false);
+        });
+    });
+}
+
 // Connect to ESP32
 async function connectESP32() {
+    if (ESP32_TCP) return connectESP32Tcp();
+
     try {
         const portPath = await findESP32();
         if (!portPath) return false;
@@ -81,8 +121,6 @@ async function connectESP32() {
             autoOpen: false
         });
 
-    esp32Parser = esp32Port.pipe(new ReadlineParser({ delimiter: '\n' }));
-
         return new Promise((resolve) => {
             esp32Port.open((err) => {
                 if (err) {
@@ -94,7 +132,7 @@ async function connectESP32() {
                 logSuccess(`ESP32 connected on ${portPath}`);
 
                 // Handle incoming data from ESP32
-                setupESP32DataHandlers();
+                setupESP32DataHandlers(esp32Port);
 
                 esp32Port.on('error', (err) => {
                     logError('ESP32 port error', err);
@@ -116,12 +154,11 @@ async function connectESP32() {
 }
 
 // Setup ESP32 data parsing handlers
-function setupESP32DataHandlers() {
+function setupESP32DataHandlers(stream) {
     let jsonBuffer = '';
     let braceDepth = 0;
     
-    esp32Parser.on('data', (data) => {
-        const line = data.toString();
+    const handleLine = (line) => {
         const trimmed = line.trimEnd();
 
         // Track brace depth to reconstruct multi-line JSON
@@ -143,7 +180,16 @@ function setupESP32DataHandlers() {
         if (trimmed) {
             processESP32Message(trimmed);
         }
-    });
+    };
+
+    stream.on('data', createDeviceStreamSplitter({ onLine: handleLine, onFrame: processESP32LogFrame }));
+}
+
+// Binary log frames are formatted here instead of on the device
+function processESP32LogFrame(frame) {
+    const log = formatLogFrame(logTable, frame);
+    console.log(`📟 ESP32 ${log.level} (${log.timestamp}) ${log.message}`);
+    broadcastToClients(JSON.stringify({ type: 'device_log', ...log }));
 }
 
 // Process and broadcast ESP32 messages
@@ -162,7 +208,6 @@ function processESP32Message(message) {
 function reconnectESP32() {
     if (esp32Port) {
         esp32Port = null;
-        esp32Parser = null;
     }
     
     console.log('🔄 Reconnecting in 3 seconds...');
@@ -0,0 +1,37 @@
+import { describe, it, expect } from "vitest";
+import { EffectOp, EffectProgram } from "./effectProgram";
+
+describe("effect program builder", () => {
+  it("encodes keyframes inside a loop", () => {
+    const bytes = new EffectProgram()
+      .loop(0, (p) => p.fade(255, 0, 0, 1000).fade(0, 0, 255, 1000))
+      .toBytes();
+    expect(Array.from(bytes)).toEqual([
+      EffectOp.LOOP, 0,
+      EffectOp.FADE, 255, 0, 0, 0xe8, 0x03,
+      EffectOp.FADE, 0, 0, 255, 0xe8, 0x03,
+      EffectOp.NEXT,
+    ]);
+  });
+
+  it("sizes conditional bodies for the skip operand", () => {
+    const bytes = new EffectProgram()
+      .when("sound", "==", 1, (p) => p.note(440, 100, 200).wait(50))
+      .toBytes();
+    expect(Array.from(bytes.slice(0, 7))).toEqual([EffectOp.IF, 1, 2, 1, 0, 9, 0]);
+    expect(bytes.length).toBe(7 + 9);
+  });
+
+  it("rejects out-of-range operands and oversized programs", () => {
+    expect(() => new EffectProgram().rgb(256, 0, 0)).toThrow(RangeError);
+    expect(() => new EffectProgram().wait(70000)).toThrow(RangeError);
+    const big = new EffectProgram();
+    for (let i = 0; i < 200; i++) big.wait(10);
+    expect(() => big.toBytes()).toThrow(RangeError);
+  });
+
+  it("base64-encodes for upload", () => {
+    const program = new EffectProgram().rgb(1, 2, 3).end();
+    expect(Buffer.from(program.toBase64(), "base64")).toEqual(Buffer.from([1, 1, 2, 3, 0]));
+  });
+});
@@ -0,0 +1,103 @@
+// Bytecode builder for ESP32 effect programs.
+// Mirrors the instruction set in main/effect_vm.h: programs are uploaded once
+// with `upload_effect` and then run on the device at full frame rate.
+
+export const EffectOp = {
+  END: 0x00,
+  RGB: 0x01,
+  FADE: 0x02,
+  WAIT: 0x03,
+  NOTE: 0x04,
+  LOOP: 0x05,
+  NEXT: 0x06,
+  IF: 0x07,
+  JUMP: 0x08,
+} as const;
+
+export const MAX_EFFECT_PROGRAM_BYTES = 512;
+
+export type EffectSensor = "light" | "sound";
+export type EffectComparison = "<" | ">" | "==";
+
+const SENSORS: Record<EffectSensor, number> = { light: 0, sound: 1 };
+const COMPARISONS: Record<EffectComparison, number> = { "<": 0, ">": 1, "==": 2 };
+
+function checkRange(name: string, value: number, max: number): number {
+  if (!Number.isInteger(value) || value < 0 || value > max) {
+    throw new RangeError(`${name} must be an integer between 0 and ${max}`);
+  }
+  return value;
+}
+
+const u8 = (name: string, v: number) => [checkRange(name, v, 0xff)];
+const u16 = (name: string, v: number) => {
+  checkRange(name, v, 0xffff);
+  return [v & 0xff, v >> 8];
+};
+
+export class EffectProgram {
+  private bytes: number[] = [];
+
+  /** Set the LEDs immediately. */
+  rgb(r: number, g: number, b: number): this {
+    this.bytes.push(EffectOp.RGB, ...u8("r", r), ...u8("g", g), ...u8("b", b));
+    return this;
+  }
+
+  /** Keyframe: fade linearly from the current colour to r, g, b. */
+  fade(r: number, g: number, b: number, ms: number): this {
+    this.bytes.push(EffectOp.FADE, ...u8("r", r), ...u8("g", g), ...u8("b", b), ...u16("ms", ms));
+    return this;
+  }
+
+  wait(ms: number): this {
+    this.bytes.push(EffectOp.WAIT, ...u16("ms", ms));
+    return this;
+  }
+
+  /** Play a buzzer note for ms, then silence. */
+  note(frequency: number, volume: number, ms: number): this {
+    this.bytes.push(EffectOp.NOTE, ...u16("frequency", frequency), ...u8("volume", volume), ...u16("ms", ms));
+    return this;
+  }
+
+  /** Repeat body `count` times; 0 repeats forever. */
+  loop(count: number, body: (p: EffectProgram) => void): this {
+    this.bytes.push(EffectOp.LOOP, ...u8("count", count));
+    body(this);
+    this.bytes.push(EffectOp.NEXT);
+    return this;
+  }
+
+  /** Run body only while `sensor cmp value` holds when it is reached. */
+  when(sensor: EffectSensor, cmp: EffectComparison, value: number, body: (p: EffectProgram) => void): this {
+    const inner = new EffectProgram();
+    body(inner);
+    this.bytes.push(
+      EffectOp.IF,
+      SENSORS[sensor],
+      COMPARISONS[cmp],
+      ...u16("value", value),
+      ...u16("body length", inner.bytes.length),
+      ...inner.bytes
+    );
+    return this;
+  }
+
+  end(): this {
+    this.bytes.push(EffectOp.END);
+    return this;
+  }
+
+  toBytes(): Uint8Array {
+    if (this.bytes.length > MAX_EFFECT_PROGRAM_BYTES) {
+      throw new RangeError(`Effect program is ${this.bytes.length} bytes (max ${MAX_EFFECT_PROGRAM_BYTES})`);
+    }
+    return Uint8Array.from(this.bytes);
+  }
+
+  /** Encoding expected by the `upload_effect` command. */
+  toBase64(): string {
+    return btoa(String.fromCharCode(...this.toBytes()));
+  }
+}
@@ -1,6 +1,8 @@
 // ESP32 Communication Utility
 // This utility provides functions to send commands to the ESP32-S3 Smart Alarm
 
+import type { EffectProgram } from "./effectProgram";
+
 interface ESP32Response {
   success: boolean;
   message?: string;
@@ -66,11 +68,24 @@ class ESP32Controller {
   }
 
   async startRainbow(): Promise<ESP32Response> {
-    return this.sendCommand('set_rgb');
+    return this.startEffect('rainbow');
   }
 
   async nightLight(): Promise<ESP32Response> {
-    return this.sendCommand('night_light');
+    return this.startEffect('night_light');
+  }
+
+  // Effect programs run on the device; upload once, then start by name
+  async startEffect(name: string): Promise<ESP32Response> {
+    return this.sendCommand('start_effect', { name });
+  }
+
+  async uploadEffect(name: string, program: EffectProgram): Promise<ESP32Response> {
+    return this.sendCommand('upload_effect', { name, program: program.toBase64() });
+  }
+
+  async deleteEffect(name: string): Promise<ESP32Response> {
+    return this.sendCommand('delete_effect', { name });
   }
 
   // Control commands
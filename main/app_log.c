@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "app_log.h"
+
+static const char *const s_event_args[] = {
+#define LOG_EVENT(name, level, args, format) args,
+#include "log_events.def"
+#undef LOG_EVENT
+};
+
+#if CONFIG_SLEEPSYNC_BINARY_LOG
+static app_log_sink_t s_sink;
+#else
+static const char *TAG = "SLEEPSYNC_ESP32";
+
+static const esp_log_level_t s_event_level[] = {
+#define LOG_EVENT(name, level, args, format) ESP_LOG_##level,
+#include "log_events.def"
+#undef LOG_EVENT
+};
+
+static const char *const s_event_format[] = {
+#define LOG_EVENT(name, level, args, format) format,
+#include "log_events.def"
+#undef LOG_EVENT
+};
+#endif
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+}
+
+size_t app_log_encode(uint8_t *out, size_t cap, log_event_t event, uint32_t timestamp_ms, va_list args) {
+    if ((unsigned)event >= LOG_EVT_COUNT || cap < 8) return 0;
+    if (cap > 257) cap = 257;   // len is a single byte
+
+    size_t pos = 2;
+    put_u16(out + pos, (uint16_t)event);
+    pos += 2;
+    put_u32(out + pos, timestamp_ms);
+    pos += 4;
+
+    for (const char *sig = s_event_args[event]; *sig; sig++) {
+        if (*sig == 's') {
+            const char *str = va_arg(args, const char *);
+            size_t len = str ? strlen(str) : 0;
+            if (pos + 1 > cap) break;
+            if (len > cap - pos - 1) len = cap - pos - 1;
+            out[pos++] = (uint8_t)len;
+            memcpy(out + pos, str, len);
+            pos += len;
+        } else {
+            uint32_t value = (*sig == 'u') ? va_arg(args, unsigned) : (uint32_t)va_arg(args, int);
+            if (pos + 4 > cap) break;
+            put_u32(out + pos, value);
+            pos += 4;
+        }
+    }
+
+    out[0] = APP_LOG_FRAME_MARKER;
+    out[1] = (uint8_t)(pos - 2);
+    return pos;
+}
+
+void app_log_set_sink(app_log_sink_t sink) {
+#if CONFIG_SLEEPSYNC_BINARY_LOG
+    s_sink = sink;
+#else
+    (void)sink;
+#endif
+}
+
+void app_log_write(log_event_t event, ...) {
+    if ((unsigned)event >= LOG_EVT_COUNT) return;
+
+    va_list args;
+    va_start(args, event);
+#if CONFIG_SLEEPSYNC_BINARY_LOG
+    uint8_t frame[APP_LOG_MAX_FRAME];
+    size_t len = app_log_encode(frame, sizeof(frame), event, esp_log_timestamp(), args);
+    if (len && s_sink) {
+        s_sink(frame, len);
+    }
+#else
+    char line[128];
+    vsnprintf(line, sizeof(line), s_event_format[event], args);
+    ESP_LOG_LEVEL(s_event_level[event], TAG, "%s", line);
+#endif
+    va_end(args);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Structured Logging ---
+// Log sites name an event from log_events.def instead of passing a format
+// string. With CONFIG_SLEEPSYNC_BINARY_LOG the event ID and raw arguments are
+// packed into a small frame and handed to the sink; formatting happens on the
+// host. Otherwise the event's format string is expanded through ESP_LOG.
+//
+// Frames are not a separate channel: the sink queues them on the TX ring, so
+// they are multiplexed in-band with the JSON messages on whatever transport
+// is active. Any client of the protocol link (the bridge, a raw TCP client)
+// must split them off by the 0x1E marker and length byte.
+//
+// Frame layout (little endian), 0x1E never occurs in the JSON stream:
+//   [0x1E] [len] [event id:2] [timestamp ms:4] [args...]
+//   len counts the bytes after itself; i/u args are 4 bytes, s args are
+//   [length:1][bytes] truncated to fit the frame.
+typedef enum {
+#define LOG_EVENT(name, level, args, format) LOG_EVT_##name,
+#include "log_events.def"
+#undef LOG_EVENT
+    LOG_EVT_COUNT
+} log_event_t;
+
+// Argument count of each event, from its signature string. APP_LOG checks
+// it at compile time, since the arguments go through va_arg unchecked.
+enum {
+#define LOG_EVENT(name, level, args, format) LOG_NARGS_##name = sizeof(args) - 1,
+#include "log_events.def"
+#undef LOG_EVENT
+};
+
+#define APP_LOG_FRAME_MARKER    0x1E
+#define APP_LOG_MAX_FRAME       96
+
+typedef void (*app_log_sink_t)(const uint8_t *frame, size_t len);
+
+// Where binary frames go; frames logged before a sink is set are dropped
+void app_log_set_sink(app_log_sink_t sink);
+
+void app_log_write(log_event_t event, ...);
+
+// Encode one frame into out; returns the frame length, 0 if event is invalid
+size_t app_log_encode(uint8_t *out, size_t cap, log_event_t event, uint32_t timestamp_ms, va_list args);
+
+// Number of macro arguments, 0-8
+#define APP_LOG_NARGS(...) APP_LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define APP_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+#define APP_LOG(event, ...) do { \
+        _Static_assert(APP_LOG_NARGS(__VA_ARGS__) == LOG_NARGS_##event, \
+                       "APP_LOG(" #event "): argument count does not match log_events.def"); \
+        app_log_write(LOG_EVT_##event, ##__VA_ARGS__); \
+    } while (0)
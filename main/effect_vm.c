@@ -0,0 +1,219 @@
+#include <string.h>
+#include "effect_vm.h"
+
+// Operand bytes following each opcode
+static int operand_size(uint8_t op) {
+    switch (op) {
+    case EFFECT_OP_END:  return 0;
+    case EFFECT_OP_RGB:  return 3;
+    case EFFECT_OP_FADE: return 5;
+    case EFFECT_OP_WAIT: return 2;
+    case EFFECT_OP_NOTE: return 5;
+    case EFFECT_OP_LOOP: return 1;
+    case EFFECT_OP_NEXT: return 0;
+    case EFFECT_OP_IF:   return 6;
+    case EFFECT_OP_JUMP: return 2;
+    default:             return -1;
+    }
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+bool effect_vm_validate(const uint8_t *code, size_t len) {
+    if (!code || len == 0 || len > EFFECT_VM_MAX_PROGRAM) return false;
+
+    // Scope of every instruction start: 0 = not an instruction start,
+    // 1 = top level, 2 + n = body of the n-th LOOP (NEXT belongs to the body
+    // it closes). Branches must stay in their own scope, so they can never
+    // enter or leave a loop body behind the interpreter's loop stack.
+    uint8_t scope[EFFECT_VM_MAX_PROGRAM + 1] = {0};
+    uint8_t body[EFFECT_VM_MAX_LOOPS + 1] = {1};   // scope of each open LOOP body
+    int depth = 0;
+    int loops = 0;
+
+    for (size_t pc = 0; pc < len; ) {
+        int size = operand_size(code[pc]);
+        if (size < 0 || pc + 1 + size > len) return false;
+        scope[pc] = body[depth];
+
+        if (code[pc] == EFFECT_OP_LOOP) {
+            if (++depth > EFFECT_VM_MAX_LOOPS) return false;
+            body[depth] = (uint8_t)(2 + loops++);   // at most 170 LOOPs fit in 512 bytes
+        }
+        if (code[pc] == EFFECT_OP_NEXT) {
+            if (depth == 0) return false;
+            depth--;
+        }
+        pc += 1 + size;
+    }
+    if (depth != 0) return false;
+    scope[len] = 1;     // falling off the end is a valid top-level target
+
+    for (size_t pc = 0; pc < len; pc += 1 + operand_size(code[pc])) {
+        long target;
+        if (code[pc] == EFFECT_OP_IF) {
+            target = (long)(pc + 7) + get_u16(&code[pc + 5]);
+        } else if (code[pc] == EFFECT_OP_JUMP) {
+            target = (long)(pc + 3) + (int16_t)get_u16(&code[pc + 1]);
+        } else {
+            continue;
+        }
+        if (target < 0 || target > (long)len) return false;
+        if (scope[target] != scope[pc]) return false;
+    }
+    return true;
+}
+
+void effect_vm_start(effect_vm_t *vm, const uint8_t *code, size_t len, const effect_vm_io_t *io) {
+    memset(vm, 0, sizeof(*vm));
+    vm->code = code;
+    vm->len = len;
+    vm->io = io;
+    vm->status = EFFECT_VM_RUNNING;
+}
+
+static void write_rgb(effect_vm_t *vm, uint8_t red, uint8_t green, uint8_t blue) {
+    if (vm->rgb[0] == red && vm->rgb[1] == green && vm->rgb[2] == blue) return;
+    vm->rgb[0] = red;
+    vm->rgb[1] = green;
+    vm->rgb[2] = blue;
+    vm->io->set_rgb(red, green, blue);
+}
+
+static effect_vm_status_t finish(effect_vm_t *vm, effect_vm_status_t status) {
+    if (vm->tone_on) {
+        vm->io->set_tone(0, 0);
+        vm->tone_on = false;
+    }
+    vm->busy = false;
+    vm->fading = false;
+    vm->status = status;
+    return status;
+}
+
+static bool compare(int32_t lhs, uint8_t cmp, int32_t rhs) {
+    switch (cmp) {
+    case EFFECT_CMP_LT: return lhs < rhs;
+    case EFFECT_CMP_GT: return lhs > rhs;
+    case EFFECT_CMP_EQ: return lhs == rhs;
+    default:            return false;
+    }
+}
+
+static void update_fade(effect_vm_t *vm, uint32_t now_ms) {
+    uint32_t elapsed = now_ms - vm->fade_start_ms;
+    uint8_t c[3];
+    for (int i = 0; i < 3; i++) {
+        int32_t delta = (int32_t)vm->fade_to[i] - vm->fade_from[i];
+        c[i] = (uint8_t)(vm->fade_from[i] + delta * (int32_t)elapsed / (int32_t)vm->fade_duration_ms);
+    }
+    write_rgb(vm, c[0], c[1], c[2]);
+}
+
+effect_vm_status_t effect_vm_tick(effect_vm_t *vm, uint32_t now_ms) {
+    if (vm->status != EFFECT_VM_RUNNING) return vm->status;
+
+    // Timed instructions are scheduled back to back on the program's own
+    // timeline (t), so a late tick catches up instead of stretching the
+    // animation
+    uint32_t t = now_ms;
+
+    for (int steps = 0; steps < EFFECT_VM_STEPS_PER_TICK; steps++) {
+        if (vm->busy) {
+            if ((int32_t)(now_ms - vm->busy_until_ms) < 0) {
+                if (vm->fading) update_fade(vm, now_ms);
+                return EFFECT_VM_RUNNING;
+            }
+            if (vm->fading) {
+                write_rgb(vm, vm->fade_to[0], vm->fade_to[1], vm->fade_to[2]);
+                vm->fading = false;
+            }
+            if (vm->tone_on) {
+                vm->io->set_tone(0, 0);
+                vm->tone_on = false;
+            }
+            vm->busy = false;
+            t = vm->busy_until_ms;
+        }
+
+        if (vm->pc >= vm->len) return finish(vm, EFFECT_VM_DONE);
+
+        const uint8_t *ins = &vm->code[vm->pc];
+        vm->pc += 1 + operand_size(ins[0]);
+
+        switch (ins[0]) {
+        case EFFECT_OP_END:
+            return finish(vm, EFFECT_VM_DONE);
+
+        case EFFECT_OP_RGB:
+            write_rgb(vm, ins[1], ins[2], ins[3]);
+            break;
+
+        case EFFECT_OP_FADE: {
+            uint16_t duration = get_u16(&ins[4]);
+            if (duration == 0) {
+                write_rgb(vm, ins[1], ins[2], ins[3]);
+                break;
+            }
+            memcpy(vm->fade_from, vm->rgb, 3);
+            memcpy(vm->fade_to, &ins[1], 3);
+            vm->fade_start_ms = t;
+            vm->fade_duration_ms = duration;
+            vm->fading = true;
+            vm->busy = true;
+            vm->busy_until_ms = t + duration;
+            break;
+        }
+
+        case EFFECT_OP_WAIT:
+        case EFFECT_OP_NOTE: {
+            uint16_t duration = get_u16(ins[0] == EFFECT_OP_WAIT ? &ins[1] : &ins[4]);
+            if (ins[0] == EFFECT_OP_NOTE && ins[3] > 0) {
+                vm->io->set_tone(get_u16(&ins[1]), ins[3]);
+                vm->tone_on = true;
+            }
+            if (duration == 0) break;
+            vm->busy = true;
+            vm->busy_until_ms = t + duration;
+            break;
+        }
+
+        case EFFECT_OP_LOOP:
+            if (vm->depth == EFFECT_VM_MAX_LOOPS) return finish(vm, EFFECT_VM_ERROR);
+            vm->loops[vm->depth].body = vm->pc;
+            vm->loops[vm->depth].remaining = ins[1];
+            vm->depth++;
+            break;
+
+        case EFFECT_OP_NEXT: {
+            if (vm->depth == 0) return finish(vm, EFFECT_VM_ERROR);
+            effect_vm_loop_t *loop = &vm->loops[vm->depth - 1];
+            if (loop->remaining == 0 || --loop->remaining > 0) {
+                vm->pc = loop->body;
+            } else {
+                vm->depth--;
+            }
+            break;
+        }
+
+        case EFFECT_OP_IF: {
+            int32_t value = vm->io->read_sensor((effect_sensor_t)ins[1]);
+            if (!compare(value, ins[2], get_u16(&ins[3]))) {
+                vm->pc += get_u16(&ins[5]);
+            }
+            break;
+        }
+
+        case EFFECT_OP_JUMP:
+            vm->pc = (size_t)((long)vm->pc + (int16_t)get_u16(&ins[1]));
+            break;
+
+        default:
+            return finish(vm, EFFECT_VM_ERROR);
+        }
+    }
+
+    return EFFECT_VM_RUNNING;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Effect Bytecode ---
+// Light/sound programs uploaded once and run on the device by the effect
+// engine, so animations need no per-frame traffic. Multi-byte operands are
+// little endian; durations are milliseconds.
+//
+//   END                                   stop the program
+//   RGB    r g b                          set the LEDs immediately
+//   FADE   r g b dur:2                    keyframe: fade linearly to r g b
+//   WAIT   dur:2                          hold the current output
+//   NOTE   freq:2 vol dur:2               play a buzzer note, then silence
+//   LOOP   count                          repeat the body up to NEXT
+//                                         (count 0 = forever)
+//   NEXT                                  end of the innermost LOOP body
+//   IF     sensor cmp value:2 skip:2      skip the next skip bytes unless
+//                                         sensor <cmp> value holds
+//   JUMP   offset:2                       signed jump, relative to the next
+//                                         instruction
+//
+// IF and JUMP targets must be an instruction in the same loop body as the
+// branch (its NEXT included), or the end of the program from the top level;
+// branching into or out of a loop body is rejected.
+//
+// Programs are checked once with effect_vm_validate() before they are stored,
+// so the interpreter can trust operand bounds, jump targets and the loop
+// stack.
+typedef enum {
+    EFFECT_OP_END   = 0x00,
+    EFFECT_OP_RGB   = 0x01,
+    EFFECT_OP_FADE  = 0x02,
+    EFFECT_OP_WAIT  = 0x03,
+    EFFECT_OP_NOTE  = 0x04,
+    EFFECT_OP_LOOP  = 0x05,
+    EFFECT_OP_NEXT  = 0x06,
+    EFFECT_OP_IF    = 0x07,
+    EFFECT_OP_JUMP  = 0x08,
+} effect_op_t;
+
+typedef enum {
+    EFFECT_SENSOR_LIGHT = 0,    // raw ADC level, 0-4095
+    EFFECT_SENSOR_SOUND = 1,    // 1 while sound is detected
+} effect_sensor_t;
+
+typedef enum {
+    EFFECT_CMP_LT = 0,
+    EFFECT_CMP_GT = 1,
+    EFFECT_CMP_EQ = 2,
+} effect_cmp_t;
+
+typedef enum {
+    EFFECT_VM_RUNNING,
+    EFFECT_VM_DONE,
+    EFFECT_VM_ERROR,
+} effect_vm_status_t;
+
+#define EFFECT_VM_MAX_PROGRAM       512  // bytes
+#define EFFECT_VM_MAX_LOOPS         4
+#define EFFECT_VM_STEPS_PER_TICK    64   // instruction budget per tick
+
+// Output and sensor hooks supplied by the effect engine
+typedef struct {
+    void (*set_rgb)(uint8_t red, uint8_t green, uint8_t blue);
+    void (*set_tone)(uint32_t frequency, uint8_t volume);   // volume 0 = silence
+    int32_t (*read_sensor)(effect_sensor_t sensor);
+} effect_vm_io_t;
+
+typedef struct {
+    size_t body;                // pc of the first body instruction
+    uint8_t remaining;          // iterations left, 0 = forever
+} effect_vm_loop_t;
+
+typedef struct {
+    const uint8_t *code;
+    size_t len;
+    size_t pc;
+    const effect_vm_io_t *io;
+    effect_vm_status_t status;
+
+    uint8_t rgb[3];             // last colour written
+    uint32_t busy_until_ms;     // current WAIT/FADE/NOTE ends here
+    bool busy;
+    bool fading;
+    bool tone_on;
+    uint8_t fade_from[3];
+    uint8_t fade_to[3];
+    uint32_t fade_start_ms;
+    uint32_t fade_duration_ms;
+
+    effect_vm_loop_t loops[EFFECT_VM_MAX_LOOPS];
+    uint8_t depth;
+} effect_vm_t;
+
+// Check a program before it is stored or run: size limit, known opcodes,
+// complete operands, balanced LOOP/NEXT nesting and branch targets that are
+// instruction starts in the branch's own loop body.
+bool effect_vm_validate(const uint8_t *code, size_t len);
+
+// Start a validated program. code must stay valid while the VM runs.
+void effect_vm_start(effect_vm_t *vm, const uint8_t *code, size_t len, const effect_vm_io_t *io);
+
+// Advance the program to now_ms: update a running fade and execute
+// instructions until one needs time to pass. Call periodically.
+effect_vm_status_t effect_vm_tick(effect_vm_t *vm, uint32_t now_ms);
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+"""Generate the host-side string table for binary log frames.
+
+Reads log_events.def and writes a JSON file the bridge uses to format
+frames emitted with CONFIG_SLEEPSYNC_BINARY_LOG. Event IDs follow table order,
+exactly as the LOG_EVT_* enum in app_log.h assigns them.
+"""
+import json
+import re
+import sys
+
+EVENT_RE = re.compile(r'^\s*LOG_EVENT\(\s*(\w+)\s*,\s*(ERROR|WARN|INFO)\s*,\s*"([ius]*)"\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+LEVELS = {'ERROR': 'E', 'WARN': 'W', 'INFO': 'I'}
+
+
+def parse(path):
+    events = []
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            m = EVENT_RE.match(line)
+            if not m:
+                continue
+            name, level, args, fmt = m.groups()
+            events.append({
+                'id': len(events),
+                'name': name,
+                'level': LEVELS[level],
+                'args': args,
+                'format': json.loads('"' + fmt + '"'),
+            })
+    return events
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit('usage: gen_log_strings.py <log_events.def> <output.json>')
+    table = {'marker': 0x1E, 'events': parse(sys.argv[1])}
+    with open(sys.argv[2], 'w', encoding='utf-8') as f:
+        json.dump(table, f, ensure_ascii=False, indent=2)
+        f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
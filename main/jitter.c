@@ -0,0 +1,39 @@
+#include "jitter.h"
+
+void jitter_tracker_init(jitter_tracker_t *t, int64_t period_us) {
+    t->period_us = period_us;
+    jitter_tracker_reset(t);
+}
+
+void jitter_tracker_reset(jitter_tracker_t *t) {
+    t->last_us = -1;
+    t->samples = 0;
+    t->min_dev_us = 0;
+    t->max_dev_us = 0;
+    t->sum_abs_us = 0;
+}
+
+void jitter_tracker_mark(jitter_tracker_t *t, int64_t now_us) {
+    if (t->last_us >= 0) {
+        jitter_tracker_record(t, (now_us - t->last_us) - t->period_us);
+    }
+    t->last_us = now_us;
+}
+
+void jitter_tracker_record(jitter_tracker_t *t, int64_t dev_us) {
+    if (t->samples == 0 || dev_us < t->min_dev_us) t->min_dev_us = dev_us;
+    if (t->samples == 0 || dev_us > t->max_dev_us) t->max_dev_us = dev_us;
+    t->sum_abs_us += (uint64_t)(dev_us < 0 ? -dev_us : dev_us);
+    t->samples++;
+}
+
+int64_t jitter_tracker_mean_abs_us(const jitter_tracker_t *t) {
+    if (t->samples == 0) return 0;
+    return (int64_t)(t->sum_abs_us / t->samples);
+}
+
+int64_t jitter_tracker_max_abs_us(const jitter_tracker_t *t) {
+    int64_t lo = t->min_dev_us < 0 ? -t->min_dev_us : t->min_dev_us;
+    int64_t hi = t->max_dev_us < 0 ? -t->max_dev_us : t->max_dev_us;
+    return lo > hi ? lo : hi;
+}
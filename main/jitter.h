@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+// --- Jitter Tracking ---
+// Records how far each activation of a periodic task lands from its nominal
+// period. Timestamps are passed in by the caller (esp_timer_get_time() on the
+// device), so the tracker has no FreeRTOS or driver dependencies and builds
+// unchanged on the linux target.
+//
+// A tracker with period_us == 0 is a plain sample recorder: values handed to
+// jitter_tracker_record() are kept as-is, which is how command latency is
+// tracked with the same statistics.
+typedef struct {
+    int64_t period_us;      // nominal period (0 = plain sample recorder)
+    int64_t last_us;        // timestamp of the previous mark, -1 before the first
+    uint32_t samples;       // number of recorded deviations
+    int64_t min_dev_us;     // most negative deviation (early wake-ups)
+    int64_t max_dev_us;     // most positive deviation (late wake-ups)
+    uint64_t sum_abs_us;    // sum of |deviation|, for the mean
+} jitter_tracker_t;
+
+void jitter_tracker_init(jitter_tracker_t *t, int64_t period_us);
+void jitter_tracker_reset(jitter_tracker_t *t);
+
+// Mark one activation of a periodic task at now_us. The first mark only
+// establishes the reference point; every following mark records
+// (now_us - last_us) - period_us.
+void jitter_tracker_mark(jitter_tracker_t *t, int64_t now_us);
+
+// Record one deviation (or latency) sample directly.
+void jitter_tracker_record(jitter_tracker_t *t, int64_t dev_us);
+
+// Mean absolute deviation in microseconds, 0 when nothing was recorded.
+int64_t jitter_tracker_mean_abs_us(const jitter_tracker_t *t);
+
+// Largest absolute deviation in microseconds.
+int64_t jitter_tracker_max_abs_us(const jitter_tracker_t *t);
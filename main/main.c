@@ -5,34 +5,31 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/event_groups.h"
+#include "sdkconfig.h"
+#if !CONFIG_IDF_TARGET_LINUX
 #include "driver/gpio.h"
 #include "driver/ledc.h"
 #include "driver/adc.h"
+#endif
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "mbedtls/base64.h"
 #include "cJSON.h"
-// Bind console to USB Serial JTAG so getchar() uses USB
-#include "driver/usb_serial_jtag.h"
-#include "esp_vfs_dev.h"
+#include "app_log.h"
+#include "effect_vm.h"
+#include "jitter.h"
+#include "transport.h"
+#include "tx_ring.h"
 
 static const char *TAG = "SLEEPSYNC_ESP32";
 
-static const char START_ALARM = "start_sunrise";
-static const char START_ALARM = "start_sunset";
-static const char START_ALARM = "set_rgb";
-static const char START_ALARM = "set_brightness";
-
-static const char START_ALARM = "start_alarm";
-static const char stop_alarm = "stop_alarm";
-static const char enable_alarm = "enable_alarm";
-static const char disable_alarm = "disable_alarm";
-static const char disable_alarm = "test_buzzer";
-
-static const char disable_alarm = "get_status";
-static const char disable_alarm = "get_sensors";
-static const char disable_alarm = "stop_all";
-static const char disable_alarm = "reset";
-
+// The linux target has no LEDs, buzzer or sensors: outputs only update
+// g_device_state and sensors read as idle, so the protocol, effect engine
+// and TCP transport can run on the host without a board.
+#if !CONFIG_IDF_TARGET_LINUX
 // --- Hardware Pin Definitions ---
 #define RGB_R_PIN           GPIO_NUM_10    // Red LED
 #define RGB_G_PIN           GPIO_NUM_11    // Green LED  
@@ -57,6 +54,82 @@ static const char disable_alarm = "reset";
 #define ADC_CHANNEL_LIGHT       ADC1_CHANNEL_0  // GPIO1
 #define ADC_ATTEN               ADC_ATTEN_DB_12 // Full range 0-3.3V
 #define ADC_WIDTH               ADC_WIDTH_BIT_12 // 12-bit resolution
+#endif
+
+// --- Task Placement ---
+// Protocol I/O runs on one core, sampling and effects on the other (see
+// Kconfig.projbuild), so JSON parsing/formatting never delays a sample or an
+// LED step. Single-core builds (and the linux target) fall back to no affinity,
+// as does CONFIG_SLEEPSYNC_PIN_TASKS=n for comparing the two layouts.
+#if CONFIG_FREERTOS_UNICORE || !CONFIG_SLEEPSYNC_PIN_TASKS
+#define PROTOCOL_CORE           tskNO_AFFINITY
+#define APP_CORE                tskNO_AFFINITY
+#else
+#define PROTOCOL_CORE           CONFIG_SLEEPSYNC_PROTOCOL_CORE
+#define APP_CORE                CONFIG_SLEEPSYNC_APP_CORE
+#endif
+
+typedef struct {
+    const char *name;
+    uint32_t stack_size;
+    UBaseType_t priority;
+    BaseType_t core_id;
+} task_placement_t;
+
+static const task_placement_t SERIAL_INPUT_TASK = {"serial_input", 4096, CONFIG_SLEEPSYNC_SERIAL_PRIORITY, PROTOCOL_CORE};
+static const task_placement_t TX_WRITER_TASK    = {"tx_writer", 3072, CONFIG_SLEEPSYNC_TX_WRITER_PRIORITY, PROTOCOL_CORE};
+static const task_placement_t SENSOR_TASK       = {"sensor_monitor", 3072, CONFIG_SLEEPSYNC_SENSOR_PRIORITY, APP_CORE};
+static const task_placement_t SUNRISE_TASK      = {"sunrise", 3072, CONFIG_SLEEPSYNC_EFFECT_PRIORITY, APP_CORE};
+static const task_placement_t SUNSET_TASK       = {"sunset", 3072, CONFIG_SLEEPSYNC_EFFECT_PRIORITY, APP_CORE};
+static const task_placement_t ALARM_TASK        = {"alarm", 3072, CONFIG_SLEEPSYNC_EFFECT_PRIORITY, APP_CORE};
+static const task_placement_t PROGRAM_TASK      = {"effect_program", 3072, CONFIG_SLEEPSYNC_EFFECT_PRIORITY, APP_CORE};
+
+// --- Timing ---
+#define SENSOR_PERIOD_MS        100
+#define SUNRISE_STEP_MS         500  // 0.5 seconds per step for demo (normally 30s)
+#define SUNSET_STEP_MS          750  // 0.75 seconds per step for demo
+#define ALARM_ON_MS             10   // flash/beep length of each alarm cycle
+#define ALARM_OFF_MS            1000 // pause before the next cycle
+#define EFFECT_FRAME_MS         20   // effect program tick (50 fps)
+#define EFFECT_STOP_BIT         BIT0 // set while stop_all_effects() waits for effect tasks
+
+// --- Effect Programs ---
+#define EFFECT_NVS_NAMESPACE    "effects"
+#define EFFECT_NAME_MAX         15   // NVS key length limit
+
+// Built-in programs (see effect_vm.h for the bytecode). Uploaded programs
+// with the same name take precedence.
+static const uint8_t NIGHT_LIGHT_PROGRAM[] = {
+    EFFECT_OP_FADE, 60, 25, 5, 0xD0, 0x07,          // fade in to warm amber over 2s
+    EFFECT_OP_LOOP, 0,                              // forever:
+    EFFECT_OP_IF, EFFECT_SENSOR_SOUND, EFFECT_CMP_EQ, 1, 0, 12, 0,
+    EFFECT_OP_FADE, 140, 60, 15, 0x2C, 0x01,        //   on sound, brighten briefly
+    EFFECT_OP_FADE, 60, 25, 5, 0xDC, 0x05,          //   and settle back
+    EFFECT_OP_WAIT, 0xC8, 0x00,                     //   check again in 200ms
+    EFFECT_OP_NEXT,
+};
+
+static const uint8_t RAINBOW_PROGRAM[] = {
+    EFFECT_OP_LOOP, 0,                              // forever, 1s per keyframe:
+    EFFECT_OP_FADE, 255, 0, 0, 0xE8, 0x03,          //   red
+    EFFECT_OP_FADE, 255, 160, 0, 0xE8, 0x03,        //   orange/yellow
+    EFFECT_OP_FADE, 0, 255, 0, 0xE8, 0x03,          //   green
+    EFFECT_OP_FADE, 0, 160, 255, 0xE8, 0x03,        //   cyan
+    EFFECT_OP_FADE, 0, 0, 255, 0xE8, 0x03,          //   blue
+    EFFECT_OP_FADE, 160, 0, 255, 0xE8, 0x03,        //   violet
+    EFFECT_OP_NEXT,
+};
+
+typedef struct {
+    const char *name;
+    const uint8_t *code;
+    size_t len;
+} builtin_effect_t;
+
+static const builtin_effect_t BUILTIN_EFFECTS[] = {
+    {"night_light", NIGHT_LIGHT_PROGRAM, sizeof(NIGHT_LIGHT_PROGRAM)},
+    {"rainbow", RAINBOW_PROGRAM, sizeof(RAINBOW_PROGRAM)},
+};
 
 // --- System State ---
 typedef struct {
@@ -71,6 +144,7 @@ typedef struct {
     bool alarm_active;
     bool sunrise_active;
     bool sunset_active;
+    bool program_active;
     uint32_t alarm_frequency;
     uint8_t alarm_volume;
     rgb_state_t current_rgb;
@@ -90,11 +164,28 @@ static sensor_data_t g_sensor_data = {0};
 static TaskHandle_t g_alarm_task = NULL;
 static TaskHandle_t g_sunrise_task = NULL;
 static TaskHandle_t g_sunset_task = NULL;
+static TaskHandle_t g_program_task = NULL;
+static EventGroupHandle_t g_effect_events;
 static QueueHandle_t g_command_queue;
+static const transport_t *g_transport;
+static tx_ring_t g_tx_ring;
+static TaskHandle_t g_tx_writer_task = NULL;
+static TaskHandle_t g_serial_input_task = NULL;
+static int64_t g_command_start_us;      // only touched by serial_input_task
+
+// Timing statistics, written by the owning task and read by get_timing
+static portMUX_TYPE g_timing_lock = portMUX_INITIALIZER_UNLOCKED;
+static jitter_tracker_t g_sensor_jitter;
+static jitter_tracker_t g_effect_jitter;
+static jitter_tracker_t g_command_latency;
 
-// List of commands
-const 
+// Effect program currently loaded for program_task
+static uint8_t g_program_code[EFFECT_VM_MAX_PROGRAM];
+static size_t g_program_len;
+static char g_program_name[EFFECT_NAME_MAX + 1];
+static effect_vm_t g_program_vm;
 
+#if !CONFIG_IDF_TARGET_LINUX
 // --- Hardware Setup ---
 static esp_err_t setup_gpio(void) {
     // Configure input pins
@@ -108,7 +199,7 @@ static esp_err_t setup_gpio(void) {
     esp_err_t ret = gpio_config(&input_conf);
     if (ret != ESP_OK) return ret;
     
-    ESP_LOGI(TAG, "✅ GPIO configured - Sound sensor ready");
+    APP_LOG(GPIO_READY);
     return ESP_OK;
 }
 
@@ -120,7 +211,7 @@ static esp_err_t setup_adc(void) {
     ret = adc1_config_channel_atten(ADC_CHANNEL_LIGHT, ADC_ATTEN);
     if (ret != ESP_OK) return ret;
     
-    ESP_LOGI(TAG, "✅ ADC configured - Light sensor ready");
+    APP_LOG(ADC_READY);
     return ESP_OK;
 }
 
@@ -170,14 +261,16 @@ static esp_err_t setup_ledc(void) {
     ret = ledc_channel_config(&buzzer_channel);
     if (ret != ESP_OK) return ret;
 
-    ESP_LOGI(TAG, "✅ LEDC configured - RGB LEDs + Buzzer ready");
+    APP_LOG(LEDC_READY);
     return ESP_OK;
 }
+#endif
 
 // --- Device Control Functions ---
 static esp_err_t set_rgb_color(uint8_t red, uint8_t green, uint8_t blue) {
     esp_err_t ret = ESP_OK;
     
+#if !CONFIG_IDF_TARGET_LINUX
     ret |= ledc_set_duty(LEDC_MODE, LEDC_CH0_CHANNEL, red);
     ret |= ledc_set_duty(LEDC_MODE, LEDC_CH1_CHANNEL, green);
     ret |= ledc_set_duty(LEDC_MODE, LEDC_CH2_CHANNEL, blue);
@@ -185,6 +278,7 @@ static esp_err_t set_rgb_color(uint8_t red, uint8_t green, uint8_t blue) {
     ret |= ledc_update_duty(LEDC_MODE, LEDC_CH0_CHANNEL);
     ret |= ledc_update_duty(LEDC_MODE, LEDC_CH1_CHANNEL);
     ret |= ledc_update_duty(LEDC_MODE, LEDC_CH2_CHANNEL);
+#endif
     
     if (ret == ESP_OK) {
         g_device_state.current_rgb.red = red;
@@ -199,15 +293,19 @@ static esp_err_t set_buzzer(uint32_t frequency, uint8_t volume) {
     esp_err_t ret = ESP_OK;
     
     if (volume > 0 && frequency > 0) {
+#if !CONFIG_IDF_TARGET_LINUX
         ret |= ledc_set_freq(LEDC_MODE, LEDC_TIMER_1, frequency);
         ret |= ledc_set_duty(LEDC_MODE, LEDC_CH3_CHANNEL, volume);
         ret |= ledc_update_duty(LEDC_MODE, LEDC_CH3_CHANNEL);
+#endif
         
         g_device_state.alarm_frequency = frequency;
         g_device_state.alarm_volume = volume;
     } else {
+#if !CONFIG_IDF_TARGET_LINUX
         ret |= ledc_set_duty(LEDC_MODE, LEDC_CH3_CHANNEL, 0);
         ret |= ledc_update_duty(LEDC_MODE, LEDC_CH3_CHANNEL);
+#endif
         
         g_device_state.alarm_frequency = 0;
         g_device_state.alarm_volume = 0;
@@ -216,41 +314,98 @@ static esp_err_t set_buzzer(uint32_t frequency, uint8_t volume) {
     return ret;
 }
 
-static void stop_all_effects(void) {
-    // Stop all running tasks
-    if (g_alarm_task) {
-        vTaskDelete(g_alarm_task);
-        g_alarm_task = NULL;
-    }
-    if (g_sunrise_task) {
-        vTaskDelete(g_sunrise_task);
-        g_sunrise_task = NULL;
+// --- Effect Task Lifecycle ---
+// Effect tasks are never deleted from outside: one may be inside
+// tx_ring_push() (a response or log frame), and killing it between claiming
+// and publishing a slot would stall the link for good. Instead an effect is
+// marked active before its task is created, stop_all_effects() clears the
+// flag and wakes the task, and the task clears its handle and deletes itself.
+static bool effect_task_running(TaskHandle_t task) {
+    return task && task != xTaskGetCurrentTaskHandle();
+}
+
+// vTaskDelayUntil() that returns early when stop_all_effects() is waiting;
+// callers re-check their *_active flag afterwards
+static void effect_delay_until(TickType_t *last_wake, TickType_t period) {
+    *last_wake += period;
+    TickType_t remaining = *last_wake - xTaskGetTickCount();
+    if ((int32_t)remaining > 0) {
+        xEventGroupWaitBits(g_effect_events, EFFECT_STOP_BIT, pdFALSE, pdFALSE, remaining);
     }
-    if (g_sunset_task) {
-        vTaskDelete(g_sunset_task);
-        g_sunset_task = NULL;
+}
+
+static void stop_all_effects(void) {
+    g_device_state.alarm_active = false;
+    g_device_state.sunrise_active = false;
+    g_device_state.sunset_active = false;
+    g_device_state.program_active = false;
+    
+    // Wait for the tasks to finish their current step and exit
+    xEventGroupSetBits(g_effect_events, EFFECT_STOP_BIT);
+    while (effect_task_running(g_alarm_task) || effect_task_running(g_sunrise_task) ||
+           effect_task_running(g_sunset_task) || effect_task_running(g_program_task)) {
+        vTaskDelay(1);
     }
+    xEventGroupClearBits(g_effect_events, EFFECT_STOP_BIT);
     
     // Turn off all outputs
     set_rgb_color(0, 0, 0);
     set_buzzer(0, 0);
     
-    // Update state
-    g_device_state.alarm_active = false;
-    g_device_state.sunrise_active = false;
-    g_device_state.sunset_active = false;
-    
-    ESP_LOGI(TAG, "⏹️ All effects stopped");
+    APP_LOG(EFFECTS_STOPPED);
+}
+
+// --- Task & Timing Helpers ---
+static BaseType_t start_task(TaskFunction_t fn, const task_placement_t *placement, TaskHandle_t *handle) {
+    return xTaskCreatePinnedToCore(fn, placement->name, placement->stack_size, NULL,
+                                   placement->priority, handle, placement->core_id);
+}
+
+// Marks the effect active before its task exists, so a stop racing the
+// task's first instruction still ends it
+static bool start_effect_task(TaskFunction_t fn, const task_placement_t *placement,
+                              TaskHandle_t *handle, bool *active) {
+    *active = true;
+    if (start_task(fn, placement, handle) != pdPASS) {
+        *active = false;
+        *handle = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void timing_mark(jitter_tracker_t *tracker) {
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&g_timing_lock);
+    jitter_tracker_mark(tracker, now);
+    taskEXIT_CRITICAL(&g_timing_lock);
+}
+
+static void timing_record(jitter_tracker_t *tracker, int64_t sample_us) {
+    taskENTER_CRITICAL(&g_timing_lock);
+    jitter_tracker_record(tracker, sample_us);
+    taskEXIT_CRITICAL(&g_timing_lock);
+}
+
+static void timing_restart(jitter_tracker_t *tracker, int64_t period_us) {
+    taskENTER_CRITICAL(&g_timing_lock);
+    jitter_tracker_init(tracker, period_us);
+    taskEXIT_CRITICAL(&g_timing_lock);
 }
 
 // --- Sensor Reading Functions ---
 static void read_sensors(void) {
+#if !CONFIG_IDF_TARGET_LINUX
     // Read light sensor (ADC)
     int light_raw = adc1_get_raw(ADC_CHANNEL_LIGHT);
     g_sensor_data.light_level = (light_raw < 0) ? 0 : (uint16_t)light_raw;
     
     // Read sound sensor (digital)
     g_sensor_data.sound_detected = gpio_get_level(SOUND_SENSOR_PIN);
+#else
+    g_sensor_data.light_level = 0;
+    g_sensor_data.sound_detected = false;
+#endif
     
     // TODO: Add DHT11 temperature/humidity reading
     g_sensor_data.temperature = 22.5f; // Placeholder
@@ -261,6 +416,48 @@ static void read_sensors(void) {
 }
 
 // --- JSON Output Functions ---
+// Every message goes through g_tx_ring and is written by tx_writer_task, so
+// producers never block on the link.
+static void send_tx_msg(tx_msg_t *msg, tx_class_t cls) {
+    tx_ring_push(&g_tx_ring, msg, cls);
+    if (g_tx_writer_task) {
+        xTaskNotifyGive(g_tx_writer_task);
+    }
+}
+
+// Binary log frames share the ring at the lowest priority
+static void send_log_frame(const uint8_t *frame, size_t len) {
+    tx_msg_t *msg = tx_msg_alloc(len);
+    if (msg) {
+        memcpy(msg->data, frame, len);
+        send_tx_msg(msg, TX_CLASS_LOG);
+    }
+}
+
+// Takes ownership of json; returns the newline-terminated message or NULL
+static tx_msg_t *json_to_msg(cJSON *json) {
+    char *json_string = cJSON_PrintUnformatted(json);
+    cJSON_Delete(json);
+    if (!json_string) return NULL;
+
+    size_t len = strlen(json_string);
+    tx_msg_t *msg = tx_msg_alloc(len + 1);
+    if (msg) {
+        memcpy(msg->data, json_string, len);
+        msg->data[len] = '\n';
+    }
+    free(json_string);
+    return msg;
+}
+
+// Takes ownership of json
+static void send_json(cJSON *json, tx_class_t cls) {
+    tx_msg_t *msg = json_to_msg(json);
+    if (msg) {
+        send_tx_msg(msg, cls);
+    }
+}
+
 static void send_sensor_data(void) {
     cJSON *json = cJSON_CreateObject();
     cJSON *data = cJSON_CreateObject();
@@ -273,12 +470,7 @@ static void send_sensor_data(void) {
     cJSON_AddNumberToObject(data, "timestamp", g_sensor_data.timestamp);
     cJSON_AddItemToObject(json, "data", data);
     
-    char *json_string = cJSON_Print(json);
-    if (json_string) {
-        printf("%s\n", json_string);
-        free(json_string);
-    }
-    cJSON_Delete(json);
+    send_json(json, TX_CLASS_SENSOR);
 }
 
 static void send_device_status(void) {
@@ -292,6 +484,10 @@ static void send_device_status(void) {
     cJSON_AddBoolToObject(status, "alarm_active", g_device_state.alarm_active);
     cJSON_AddBoolToObject(status, "sunrise_active", g_device_state.sunrise_active);
     cJSON_AddBoolToObject(status, "sunset_active", g_device_state.sunset_active);
+    cJSON_AddBoolToObject(status, "program_active", g_device_state.program_active);
+    if (g_device_state.program_active) {
+        cJSON_AddStringToObject(status, "program", g_program_name);
+    }
     cJSON_AddNumberToObject(status, "alarm_frequency", g_device_state.alarm_frequency);
     cJSON_AddNumberToObject(status, "alarm_volume", g_device_state.alarm_volume);
     
@@ -302,12 +498,51 @@ static void send_device_status(void) {
     
     cJSON_AddItemToObject(json, "status", status);
     
-    char *json_string = cJSON_Print(json);
-    if (json_string) {
-        printf("%s\n", json_string);
-        free(json_string);
-    }
-    cJSON_Delete(json);
+    tx_ring_stats_t tx_stats;
+    tx_ring_get_stats(&g_tx_ring, &tx_stats);
+    cJSON *tx = cJSON_CreateObject();
+    cJSON_AddNumberToObject(tx, "queued", tx_stats.queued);
+    cJSON_AddNumberToObject(tx, "pending", tx_stats.pending);
+    cJSON_AddNumberToObject(tx, "dropped_critical", tx_stats.dropped_critical);
+    cJSON_AddNumberToObject(tx, "dropped_events", tx_stats.dropped_events);
+    cJSON_AddNumberToObject(tx, "coalesced_sensor", tx_stats.coalesced_sensor);
+    cJSON_AddNumberToObject(tx, "dropped_logs", tx_stats.dropped_logs);
+    cJSON_AddItemToObject(json, "tx", tx);
+    
+    send_json(json, TX_CLASS_CRITICAL);
+}
+
+static void add_timing_stats(cJSON *parent, const char *name, const jitter_tracker_t *t) {
+    cJSON *stats = cJSON_CreateObject();
+    cJSON_AddNumberToObject(stats, "period_us", t->period_us);
+    cJSON_AddNumberToObject(stats, "samples", t->samples);
+    cJSON_AddNumberToObject(stats, "min_us", t->min_dev_us);
+    cJSON_AddNumberToObject(stats, "max_us", t->max_dev_us);
+    cJSON_AddNumberToObject(stats, "mean_abs_us", jitter_tracker_mean_abs_us(t));
+    cJSON_AddNumberToObject(stats, "max_abs_us", jitter_tracker_max_abs_us(t));
+    cJSON_AddItemToObject(parent, name, stats);
+}
+
+static void send_timing_stats(void) {
+    // Snapshot under the lock, format outside it
+    jitter_tracker_t sensor, effect, latency;
+    taskENTER_CRITICAL(&g_timing_lock);
+    sensor = g_sensor_jitter;
+    effect = g_effect_jitter;
+    latency = g_command_latency;
+    taskEXIT_CRITICAL(&g_timing_lock);
+
+    cJSON *json = cJSON_CreateObject();
+    cJSON *timing = cJSON_CreateObject();
+
+    cJSON_AddStringToObject(json, "type", "timing_stats");
+    add_timing_stats(timing, "sensor_jitter", &sensor);
+    add_timing_stats(timing, "effect_jitter", &effect);
+    add_timing_stats(timing, "command_latency", &latency);
+    cJSON_AddItemToObject(json, "timing", timing);
+    cJSON_AddNumberToObject(json, "timestamp", esp_timer_get_time());
+
+    send_json(json, TX_CLASS_CRITICAL);
 }
 
 static void send_response(const char* command, bool success, const char* message) {
@@ -319,17 +554,18 @@ static void send_response(const char* command, bool success, const char* message
     cJSON_AddStringToObject(json, "message", message);
     cJSON_AddNumberToObject(json, "timestamp", esp_timer_get_time());
     
-    char *json_string = cJSON_Print(json);
-    if (json_string) {
-        printf("%s\n", json_string);
-        free(json_string);
+    tx_msg_t *msg = json_to_msg(json);
+    if (!msg) return;
+    // Responses written by the command handler itself carry the command's
+    // arrival time, so tx_writer_task can time the full round trip
+    if (xTaskGetCurrentTaskHandle() == g_serial_input_task) {
+        msg->origin_us = g_command_start_us;
     }
-    cJSON_Delete(json);
+    send_tx_msg(msg, TX_CLASS_CRITICAL);
 }
 
 // --- Sleep Effect Tasks ---
 static void sunrise_task(void *pvParameters) {
-    g_device_state.sunrise_active = true;
     send_response("start_sunrise", true, "Sunrise simulation started");
     
     // Sunrise color progression - 20 steps over 10 minutes (30s each)
@@ -353,12 +589,14 @@ static void sunrise_task(void *pvParameters) {
     };
     
     int num_steps = sizeof(colors) / sizeof(colors[0]);
-    int delay_ms = 500; // 1 second per step for demo (normally 30s)
     
+    timing_restart(&g_effect_jitter, SUNRISE_STEP_MS * 1000LL);
+    TickType_t last_wake = xTaskGetTickCount();
     for (int i = 0; i < num_steps && g_device_state.sunrise_active; i++) {
+        timing_mark(&g_effect_jitter);
         set_rgb_color(colors[i].r, colors[i].g, colors[i].b);
-        ESP_LOGI(TAG, "🌅 Sunrise Step %d/%d", i+1, num_steps);
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+        APP_LOG(SUNRISE_STEP, i+1, num_steps);
+        effect_delay_until(&last_wake, pdMS_TO_TICKS(SUNRISE_STEP_MS));
     }
     
     if (g_device_state.sunrise_active) {
@@ -371,7 +609,6 @@ static void sunrise_task(void *pvParameters) {
 }
 
 static void sunset_task(void *pvParameters) {
-    g_device_state.sunset_active = true;
     send_response("start_sunset", true, "Sunset simulation started");
     
     // Sunset color progression (reverse of sunrise)
@@ -395,12 +632,14 @@ static void sunset_task(void *pvParameters) {
     };
     
     int num_steps = sizeof(colors) / sizeof(colors[0]);
-    int delay_ms = 750; // 0.75 seconds per step for demo
     
+    timing_restart(&g_effect_jitter, SUNSET_STEP_MS * 1000LL);
+    TickType_t last_wake = xTaskGetTickCount();
     for (int i = 0; i < num_steps && g_device_state.sunset_active; i++) {
+        timing_mark(&g_effect_jitter);
         set_rgb_color(colors[i].r, colors[i].g, colors[i].b);
-        ESP_LOGI(TAG, "🌇 Sunset Step %d/%d", i+1, num_steps);
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+        APP_LOG(SUNSET_STEP, i+1, num_steps);
+        effect_delay_until(&last_wake, pdMS_TO_TICKS(SUNSET_STEP_MS));
     }
     
     if (g_device_state.sunset_active) {
@@ -413,11 +652,13 @@ static void sunset_task(void *pvParameters) {
 }
 
 static void alarm_task(void *pvParameters) {
-    g_device_state.alarm_active = true;
     send_response("start_alarm", true, "Alarm sequence started");
     
     // Progressive alarm - increasing intensity over 2 minutes
+    timing_restart(&g_effect_jitter, (ALARM_ON_MS + ALARM_OFF_MS) * 1000LL);
+    TickType_t last_wake = xTaskGetTickCount();
     for (int cycle = 0; cycle < 30 && g_device_state.alarm_active; cycle++) {
+        timing_mark(&g_effect_jitter);
         uint8_t intensity = (50 + (cycle * 7) > 255) ? 255 : (50 + (cycle * 7)); // Prevent overflow
         
         uint32_t frequency = 800 + (cycle * 20); // Increase pitch
@@ -430,23 +671,195 @@ static void alarm_task(void *pvParameters) {
         // Flash red with increasing brightness
         set_rgb_color(intensity, 0, 0);
         set_buzzer(frequency, volume);
-        vTaskDelay(pdMS_TO_TICKS(10)); // ON ~120 ms
+        effect_delay_until(&last_wake, pdMS_TO_TICKS(ALARM_ON_MS));
 
         // Brief pause
         set_rgb_color(0, 0, 0);
+#if !CONFIG_IDF_TARGET_LINUX
         ledc_stop(LEDC_MODE, LEDC_CH3_CHANNEL, 0); // OFF hard stop
-        vTaskDelay(pdMS_TO_TICKS(1000)); // OFF ~100 ms
+#endif
+        effect_delay_until(&last_wake, pdMS_TO_TICKS(ALARM_OFF_MS));
     }
     
-    // Final fade out
-    stop_all_effects();
-    send_response("alarm_complete", true, "Alarm sequence completed");
+    // Final fade out. Only this task's outputs: stop_all_effects() is for
+    // other tasks, and a stopped alarm has already been silenced by it
+    if (g_device_state.alarm_active) {
+        set_rgb_color(0, 0, 0);
+        set_buzzer(0, 0);
+        send_response("alarm_complete", true, "Alarm sequence completed");
+    }
     
     g_device_state.alarm_active = false;
     g_alarm_task = NULL;
     vTaskDelete(NULL);
 }
+
+// --- Effect Program Engine ---
+static void program_set_rgb(uint8_t red, uint8_t green, uint8_t blue) {
+    set_rgb_color(red, green, blue);
+}
+
+static void program_set_tone(uint32_t frequency, uint8_t volume) {
+    set_buzzer(frequency, volume);
+}
+
+static int32_t program_read_sensor(effect_sensor_t sensor) {
+    switch (sensor) {
+    case EFFECT_SENSOR_LIGHT: return g_sensor_data.light_level;
+    case EFFECT_SENSOR_SOUND: return g_sensor_data.sound_detected;
+    default:                  return 0;
+    }
+}
+
+static const effect_vm_io_t PROGRAM_IO = {
+    .set_rgb = program_set_rgb,
+    .set_tone = program_set_tone,
+    .read_sensor = program_read_sensor,
+};
+
+// Runs g_program_code locally at EFFECT_FRAME_MS, so animations need no
+// per-frame traffic from the host
+static void program_task(void *pvParameters) {
+    effect_vm_start(&g_program_vm, g_program_code, g_program_len, &PROGRAM_IO);
+    
+    timing_restart(&g_effect_jitter, EFFECT_FRAME_MS * 1000LL);
+    TickType_t last_wake = xTaskGetTickCount();
+    effect_vm_status_t vm_status = EFFECT_VM_RUNNING;
+    while (vm_status == EFFECT_VM_RUNNING && g_device_state.program_active) {
+        timing_mark(&g_effect_jitter);
+        vm_status = effect_vm_tick(&g_program_vm, (uint32_t)(esp_timer_get_time() / 1000));
+        effect_delay_until(&last_wake, pdMS_TO_TICKS(EFFECT_FRAME_MS));
+    }
+    
+    if (g_device_state.program_active) {
+        if (vm_status == EFFECT_VM_DONE) {
+            send_response("effect_complete", true, "Effect program completed");
+        } else {
+            send_response("effect_complete", false, "Effect program aborted");
+        }
+    }
+    
+    g_device_state.program_active = false;
+    g_program_task = NULL;
+    vTaskDelete(NULL);
+}
+
+// Load a stored program (or a built-in one) into g_program_code
+static esp_err_t load_effect_program(const char *name) {
+    nvs_handle_t nvs;
+    if (nvs_open(EFFECT_NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+        size_t len = sizeof(g_program_code);
+        esp_err_t ret = nvs_get_blob(nvs, name, g_program_code, &len);
+        nvs_close(nvs);
+        if (ret == ESP_OK) {
+            // Re-check in case flash contents changed under us
+            if (!effect_vm_validate(g_program_code, len)) return ESP_ERR_INVALID_STATE;
+            g_program_len = len;
+            return ESP_OK;
+        }
+    }
+    
+    for (size_t i = 0; i < sizeof(BUILTIN_EFFECTS) / sizeof(BUILTIN_EFFECTS[0]); i++) {
+        if (strcmp(BUILTIN_EFFECTS[i].name, name) == 0) {
+            memcpy(g_program_code, BUILTIN_EFFECTS[i].code, BUILTIN_EFFECTS[i].len);
+            g_program_len = BUILTIN_EFFECTS[i].len;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+static esp_err_t store_effect_program(const char *name, const uint8_t *code, size_t len) {
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(EFFECT_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) return ret;
+    
+    ret = nvs_set_blob(nvs, name, code, len);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
+
+static esp_err_t delete_effect_program(const char *name) {
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(EFFECT_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) return ret;
+    
+    ret = nvs_erase_key(nvs, name);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
+
+static void send_effect_list(void) {
+    cJSON *json = cJSON_CreateObject();
+    cJSON *builtin = cJSON_CreateArray();
+    cJSON *stored = cJSON_CreateArray();
+    
+    cJSON_AddStringToObject(json, "type", "effect_list");
+    for (size_t i = 0; i < sizeof(BUILTIN_EFFECTS) / sizeof(BUILTIN_EFFECTS[0]); i++) {
+        cJSON_AddItemToArray(builtin, cJSON_CreateString(BUILTIN_EFFECTS[i].name));
+    }
+    
+    nvs_iterator_t it = NULL;
+    esp_err_t ret = nvs_entry_find(NVS_DEFAULT_PART_NAME, EFFECT_NVS_NAMESPACE, NVS_TYPE_BLOB, &it);
+    while (ret == ESP_OK) {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+        cJSON_AddItemToArray(stored, cJSON_CreateString(info.key));
+        ret = nvs_entry_next(&it);
+    }
+    nvs_release_iterator(it);
+    
+    cJSON_AddItemToObject(json, "builtin", builtin);
+    cJSON_AddItemToObject(json, "stored", stored);
+    send_json(json, TX_CLASS_CRITICAL);
+}
+
 // --- JSON Command Processing ---
+// Command arguments may sit at the top level or, as the bridge sends them,
+// inside a "data" object
+static cJSON *get_param(const cJSON *json, const char *key) {
+    cJSON *item = cJSON_GetObjectItem(json, key);
+    if (item) return item;
+    
+    cJSON *data = cJSON_GetObjectItem(json, "data");
+    return cJSON_IsObject(data) ? cJSON_GetObjectItem(data, key) : NULL;
+}
+
+static bool get_effect_name(const cJSON *json, const char **name) {
+    cJSON *item = get_param(json, "name");
+    if (!cJSON_IsString(item)) return false;
+    
+    size_t len = strlen(item->valuestring);
+    if (len == 0 || len > EFFECT_NAME_MAX) return false;
+    
+    *name = item->valuestring;
+    return true;
+}
+
+static void start_effect_program(const char *cmd, const char *name) {
+    stop_all_effects(); // Stops program_task before g_program_code is overwritten
+    
+    esp_err_t ret = load_effect_program(name);
+    if (ret != ESP_OK) {
+        send_response(cmd, false, ret == ESP_ERR_NOT_FOUND ? "Unknown effect" : "Stored effect is corrupt");
+        return;
+    }
+    
+    snprintf(g_program_name, sizeof(g_program_name), "%s", name);
+    if (!start_effect_task(program_task, &PROGRAM_TASK, &g_program_task, &g_device_state.program_active)) {
+        send_response(cmd, false, "Failed to start effect task");
+        return;
+    }
+    send_response(cmd, true, "Effect program started");
+    APP_LOG(PROGRAM_STARTED, g_program_name, (unsigned)g_program_len);
+}
+
 static void process_json_command(const char *json_str) {
     cJSON *json = cJSON_Parse(json_str);
     if (!json) {
@@ -462,13 +875,15 @@ static void process_json_command(const char *json_str) {
     }
     
     const char *cmd = command->valuestring;
-    ESP_LOGI(TAG, "📨 Processing command: %s", cmd);
+    APP_LOG(PROCESSING_COMMAND, cmd);
     
     // === LIGHTING COMMANDS ===
     if (strcmp(cmd, "start_sunrise") == 0) {
         if (!g_device_state.sunrise_active) {
             stop_all_effects(); // Stop other effects first
-            xTaskCreate(sunrise_task, "sunrise", 3072, NULL, 5, &g_sunrise_task);
+            if (!start_effect_task(sunrise_task, &SUNRISE_TASK, &g_sunrise_task, &g_device_state.sunrise_active)) {
+                send_response(cmd, false, "Failed to start sunrise task");
+            }
         } else {
             send_response(cmd, false, "Sunrise already active");
         }
@@ -476,7 +891,9 @@ static void process_json_command(const char *json_str) {
     else if (strcmp(cmd, "start_sunset") == 0) {
         if (!g_device_state.sunset_active) {
             stop_all_effects();
-            xTaskCreate(sunset_task, "sunset", 3072, NULL, 5, &g_sunset_task);
+            if (!start_effect_task(sunset_task, &SUNSET_TASK, &g_sunset_task, &g_device_state.sunset_active)) {
+                send_response(cmd, false, "Failed to start sunset task");
+            }
         } else {
             send_response(cmd, false, "Sunset already active");
         }
@@ -526,7 +943,9 @@ static void process_json_command(const char *json_str) {
     else if (strcmp(cmd, "start_alarm") == 0) {
         if (!g_device_state.alarm_active) {
             stop_all_effects();
-            xTaskCreate(alarm_task, "alarm", 3072, NULL, 5, &g_alarm_task);
+            if (!start_effect_task(alarm_task, &ALARM_TASK, &g_alarm_task, &g_device_state.alarm_active)) {
+                send_response(cmd, false, "Failed to start alarm task");
+            }
         } else {
             send_response(cmd, false, "Alarm already active");
         }
@@ -565,6 +984,54 @@ static void process_json_command(const char *json_str) {
         send_response(cmd, true, "Buzzer test completed");
     }
     
+    // === EFFECT PROGRAM COMMANDS ===
+    else if (strcmp(cmd, "upload_effect") == 0) {
+        static uint8_t program[EFFECT_VM_MAX_PROGRAM];
+        const char *name;
+        cJSON *encoded = get_param(json, "program");
+        size_t len = 0;
+        
+        if (!get_effect_name(json, &name)) {
+            send_response(cmd, false, "Invalid effect name (1-15 characters)");
+        } else if (!cJSON_IsString(encoded) ||
+                   mbedtls_base64_decode(program, sizeof(program), &len,
+                                         (const unsigned char *)encoded->valuestring,
+                                         strlen(encoded->valuestring)) != 0) {
+            send_response(cmd, false, "Invalid program (base64 bytecode, max 512 bytes)");
+        } else if (!effect_vm_validate(program, len)) {
+            send_response(cmd, false, "Program rejected by bytecode validation");
+        } else if (store_effect_program(name, program, len) != ESP_OK) {
+            send_response(cmd, false, "Failed to store effect");
+        } else {
+            send_response(cmd, true, "Effect stored");
+        }
+    }
+    else if (strcmp(cmd, "start_effect") == 0) {
+        const char *name;
+        if (get_effect_name(json, &name)) {
+            start_effect_program(cmd, name);
+        } else {
+            send_response(cmd, false, "Invalid effect name (1-15 characters)");
+        }
+    }
+    else if (strcmp(cmd, "night_light") == 0) {
+        start_effect_program(cmd, "night_light");
+    }
+    else if (strcmp(cmd, "delete_effect") == 0) {
+        const char *name;
+        if (!get_effect_name(json, &name)) {
+            send_response(cmd, false, "Invalid effect name (1-15 characters)");
+        } else if (delete_effect_program(name) != ESP_OK) {
+            send_response(cmd, false, "No stored effect with that name");
+        } else {
+            send_response(cmd, true, "Effect deleted");
+        }
+    }
+    else if (strcmp(cmd, "list_effects") == 0) {
+        send_effect_list();
+        send_response(cmd, true, "Effect list sent");
+    }
+    
     // === SYSTEM COMMANDS ===
     else if (strcmp(cmd, "get_status") == 0) {
         send_device_status();
@@ -575,6 +1042,20 @@ static void process_json_command(const char *json_str) {
         send_sensor_data();
         send_response(cmd, true, "Sensor data sent");
     }
+    else if (strcmp(cmd, "get_timing") == 0) {
+        send_timing_stats();
+        cJSON *reset = cJSON_GetObjectItem(json, "reset");
+        if (reset && cJSON_IsTrue(reset)) {
+            taskENTER_CRITICAL(&g_timing_lock);
+            jitter_tracker_reset(&g_sensor_jitter);
+            jitter_tracker_reset(&g_effect_jitter);
+            jitter_tracker_reset(&g_command_latency);
+            taskEXIT_CRITICAL(&g_timing_lock);
+            send_response(cmd, true, "Timing stats sent and reset");
+        } else {
+            send_response(cmd, true, "Timing stats sent");
+        }
+    }
     else if (strcmp(cmd, "stop_all") == 0) {
         stop_all_effects();
         send_response(cmd, true, "All effects stopped");
@@ -593,33 +1074,69 @@ static void process_json_command(const char *json_str) {
     cJSON_Delete(json);
 }
 
+// --- TX Writer Task ---
+// The only task that touches the link's send path. It may block for as long
+// as the host stops reading; producers keep running and the ring's drop
+// policy absorbs the backlog.
+static void tx_writer_task(void *pvParameters) {
+    while (1) {
+        tx_msg_t *msg = tx_ring_pop(&g_tx_ring);
+        if (!msg) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        g_transport->send(msg->data, msg->len);
+        if (msg->origin_us) {
+            timing_record(&g_command_latency, esp_timer_get_time() - msg->origin_us);
+        }
+        free(msg);
+    }
+}
+
 // --- Serial Input Task ---
+#define RX_CHUNK_SIZE           128
+#define RX_TIMEOUT_MS           100
+
 static void serial_input_task(void *pvParameters) {
-    char input_buffer[512];
+    // Static, like the upload_effect decode buffer: on the stack it would
+    // share the 4 KB with effect_vm_validate()'s scope table and NVS calls.
+    // Only this task touches it.
+    static char input_buffer[1024];     // room for a base64 upload_effect program
+    char chunk[RX_CHUNK_SIZE];
     int buffer_pos = 0;
     bool in_json = false;
     int brace_count = 0;
+    int64_t frame_start_us = 0;
     
-    ESP_LOGI(TAG, "📺 JSON Serial Interface Ready");
+    APP_LOG(SERIAL_READY);
     
     while (1) {
-        int c = getchar();
+        // Blocks in the transport until bytes arrive, so there is no polling delay
+        int n = g_transport->recv(chunk, sizeof(chunk), RX_TIMEOUT_MS);
+        if (n < 0) {
+            APP_LOG(RECEIVE_FAILED, g_transport->name);
+            vTaskDelay(pdMS_TO_TICKS(RX_TIMEOUT_MS));
+            continue;
+        }
         
-        if (c != EOF) {
+        for (int i = 0; i < n; i++) {
+            char c = chunk[i];
+            
             if (c == '{') {
                 if (!in_json) {
                     in_json = true;
                     buffer_pos = 0;
                     brace_count = 0;
+                    frame_start_us = esp_timer_get_time();
                 }
                 brace_count++;
                 if (buffer_pos < sizeof(input_buffer) - 1) {
-                    input_buffer[buffer_pos++] = (char)c;
+                    input_buffer[buffer_pos++] = c;
                 }
             }
             else if (in_json) {
                 if (buffer_pos < sizeof(input_buffer) - 1) {
-                    input_buffer[buffer_pos++] = (char)c;
+                    input_buffer[buffer_pos++] = c;
                 }
                 
                 if (c == '}') {
@@ -627,24 +1144,27 @@ static void serial_input_task(void *pvParameters) {
                     if (brace_count == 0) {
                         // Complete JSON received
                         input_buffer[buffer_pos] = '\0';
+                        g_command_start_us = frame_start_us;
                         process_json_command(input_buffer);
+                        g_command_start_us = 0;
                         in_json = false;
                         buffer_pos = 0;
                     }
                 }
             }
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(10));
     }
 }
 
 // --- Sensor Monitoring Task ---
 static void sensor_monitoring_task(void *pvParameters) {
-    ESP_LOGI(TAG, "📡 Sensor monitoring started");
+    APP_LOG(SENSOR_STARTED);
     uint64_t last_send_time = 0;
+    TickType_t last_wake = xTaskGetTickCount();
     
     while (1) {
+        timing_mark(&g_sensor_jitter);
+        
         // Read all sensors
         read_sensors();
         
@@ -665,15 +1185,11 @@ static void sensor_monitoring_task(void *pvParameters) {
                 cJSON_AddBoolToObject(json, "detected", true);
                 cJSON_AddNumberToObject(json, "timestamp", g_sensor_data.timestamp);
                 
-                char *json_string = cJSON_Print(json);
-                if (json_string) {
-                    printf("%s\n", json_string);
-                    free(json_string);
-                }
-                cJSON_Delete(json);
+                send_json(json, TX_CLASS_EVENT);
                 
                 // Brief visual feedback if no other effects running
-                if (!g_device_state.alarm_active && !g_device_state.sunrise_active && !g_device_state.sunset_active) {
+                if (!g_device_state.alarm_active && !g_device_state.sunrise_active && !g_device_state.sunset_active &&
+                    !g_device_state.program_active) {
                     rgb_state_t original = g_device_state.current_rgb;
                     set_rgb_color(255, 255, 0); // Yellow flash
                     vTaskDelay(pdMS_TO_TICKS(200));
@@ -683,7 +1199,7 @@ static void sensor_monitoring_task(void *pvParameters) {
             last_sound_state = g_sensor_data.sound_detected;
         }
         
-        vTaskDelay(pdMS_TO_TICKS(100)); // Check every 100ms
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SENSOR_PERIOD_MS)); // Check every 100ms
     }
 }
 
@@ -694,6 +1210,15 @@ void app_main(void) {
     // Initialize device state
     memset(&g_device_state, 0, sizeof(g_device_state));
     memset(&g_sensor_data, 0, sizeof(g_sensor_data));
+    jitter_tracker_init(&g_sensor_jitter, SENSOR_PERIOD_MS * 1000LL);
+    jitter_tracker_init(&g_effect_jitter, 0);
+    jitter_tracker_init(&g_command_latency, 0);
+    
+    g_effect_events = xEventGroupCreate();
+    if (!g_effect_events) {
+        ESP_LOGE(TAG, "Failed to create effect event group");
+        return;
+    }
     
     // Create command queue
     g_command_queue = xQueueCreate(10, sizeof(char*));
@@ -702,22 +1227,30 @@ void app_main(void) {
         return;
     }
 
-    // Route console I/O to USB Serial JTAG
-    usb_serial_jtag_driver_config_t usb_cfg = {
-        .tx_buffer_size = 512,
-        .rx_buffer_size = 512,
-    };
-    esp_err_t usb_ret = usb_serial_jtag_driver_install(&usb_cfg);
-    if (usb_ret == ESP_OK) {
-        esp_vfs_usb_serial_jtag_use_driver(); // Note: deprecated but still functional
-        setvbuf(stdin, NULL, _IONBF, 0);
-        setvbuf(stdout, NULL, _IONBF, 0);
-        setvbuf(stderr, NULL, _IONBF, 0);
-        ESP_LOGI(TAG, "🔌 USB Serial JTAG console active");
-    } else {
-        ESP_LOGW(TAG, "⚠️ Failed to init USB Serial JTAG (%d)", usb_ret);
+    // NVS holds uploaded effect programs
+    esp_err_t nvs_ret = nvs_flash_init();
+    if (nvs_ret == ESP_ERR_NVS_NO_FREE_PAGES || nvs_ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        nvs_ret = nvs_flash_init();
+    }
+    if (nvs_ret != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ NVS unavailable (%d) - only built-in effects", nvs_ret);
     }
+
+    // Bring up the protocol link chosen in menuconfig
+    g_transport = transport_default();
+    esp_err_t link_ret = g_transport->open();
+    if (link_ret != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Failed to open %s transport (%d)", g_transport->name, link_ret);
+        return;
+    }
+    ESP_LOGI(TAG, "🔌 Protocol transport active: %s", g_transport->name);
     
+    tx_ring_init(&g_tx_ring);
+    start_task(tx_writer_task, &TX_WRITER_TASK, &g_tx_writer_task);
+    app_log_set_sink(send_log_frame);
+    
+#if !CONFIG_IDF_TARGET_LINUX
     // Hardware initialization
     esp_err_t ret = ESP_OK;
     ret |= setup_gpio();
@@ -725,12 +1258,13 @@ void app_main(void) {
     ret |= setup_ledc();
     
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "❌ Hardware initialization failed");
+        APP_LOG(HW_INIT_FAILED);
         return;
     }
+#endif
     
     // Brief startup sequence
-    ESP_LOGI(TAG, "🔄 Running startup test...");
+    APP_LOG(STARTUP_TEST);
     set_rgb_color(255, 0, 0);   // Red
     vTaskDelay(pdMS_TO_TICKS(300));
     set_rgb_color(0, 255, 0);   // Green  
@@ -743,7 +1277,7 @@ void app_main(void) {
     vTaskDelay(pdMS_TO_TICKS(200));
     set_buzzer(0, 0);
     
-    ESP_LOGI(TAG, "✅ Hardware test complete - All systems ready!");
+    APP_LOG(HW_READY);
     
     // Send initial status
     vTaskDelay(pdMS_TO_TICKS(1000)); // Wait for serial to stabilize
@@ -755,17 +1289,12 @@ void app_main(void) {
     cJSON_AddStringToObject(ready_json, "version", "1.0.0");
     cJSON_AddNumberToObject(ready_json, "timestamp", esp_timer_get_time());
     
-    char *ready_string = cJSON_Print(ready_json);
-    if (ready_string) {
-        printf("%s\n", ready_string);
-        free(ready_string);
-    }
-    cJSON_Delete(ready_json);
+    send_json(ready_json, TX_CLASS_CRITICAL);
     
     // Start tasks
-    xTaskCreate(serial_input_task, "serial_input", 4096, NULL, 10, NULL);
-    xTaskCreate(sensor_monitoring_task, "sensor_monitor", 3072, NULL, 5, NULL);
+    start_task(serial_input_task, &SERIAL_INPUT_TASK, &g_serial_input_task);
+    start_task(sensor_monitoring_task, &SENSOR_TASK, NULL);
     
-    ESP_LOGI(TAG, "🎯 SleepSync ready! Send JSON commands via USB serial");
-    ESP_LOGI(TAG, "📡 Streaming sensor data every 2 seconds");
+    APP_LOG(READY, g_transport->name);
+    APP_LOG(STREAMING);
 }
\ No newline at end of file
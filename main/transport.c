@@ -0,0 +1,12 @@
+#include "sdkconfig.h"
+#include "transport.h"
+
+const transport_t *transport_default(void) {
+#if CONFIG_SLEEPSYNC_TRANSPORT_TCP
+    return &transport_tcp;
+#elif CONFIG_SLEEPSYNC_TRANSPORT_UART
+    return &transport_uart;
+#else
+    return &transport_usb_jtag;
+#endif
+}
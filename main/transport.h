@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// --- Protocol Transport ---
+// Byte-stream link carrying the JSON protocol. Backends are selected in
+// menuconfig ("SleepSync Firmware" -> "Protocol transport") and share one
+// contract:
+//   open   - bring the link up; called once before any other call
+//   send   - write all of len bytes; returns len when the bytes were accepted
+//            (or discarded because nobody is connected), -1 if the link failed
+//   recv   - read up to len bytes, waiting at most timeout_ms; returns the
+//            number of bytes read, 0 on timeout or while no peer is connected
+//   flush  - block until queued output has left the device or timeout_ms passed
+typedef struct {
+    const char *name;
+    esp_err_t (*open)(void);
+    int (*send)(const void *data, size_t len);
+    int (*recv)(void *buf, size_t len, uint32_t timeout_ms);
+    esp_err_t (*flush)(uint32_t timeout_ms);
+} transport_t;
+
+extern const transport_t transport_usb_jtag;
+extern const transport_t transport_uart;
+extern const transport_t transport_tcp;
+
+// Backend chosen in menuconfig
+const transport_t *transport_default(void);
@@ -0,0 +1,217 @@
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "transport.h"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "wifi_sta.h"
+#endif
+
+// Single-client TCP server. On the device it joins the configured Wi-Fi
+// network first; on the linux target it uses the host stack, so the protocol
+// can be driven over loopback without a board.
+//
+// A peer that vanishes without a FIN (Wi-Fi drop, host sleep) is caught two
+// ways: keepalive probes time the socket out, and a new connection always
+// replaces the current one, so a reconnecting host never waits on a dead peer.
+
+#define WIFI_CONNECT_TIMEOUT_MS 15000
+#define KEEPALIVE_IDLE_S        5    // idle time before the first probe
+#define KEEPALIVE_INTERVAL_S    2
+#define KEEPALIVE_COUNT         3    // unanswered probes before the link drops
+
+#define READY_LISTEN            0x1
+#define READY_CLIENT            0x2
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static const char *TAG = "TRANSPORT_TCP";
+
+static int s_listen_fd = -1;
+static int s_client_fd = -1;
+static SemaphoreHandle_t s_client_lock;
+
+// Returns READY_* bits for the listen socket and client_fd (if >= 0)
+static int select_ready(int client_fd, uint32_t timeout_ms) {
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+    FD_SET(s_listen_fd, &read_fds);
+    int max_fd = s_listen_fd;
+    if (client_fd >= 0) {
+        FD_SET(client_fd, &read_fds);
+        if (client_fd > max_fd) max_fd = client_fd;
+    }
+    struct timeval tv = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    if (select(max_fd + 1, &read_fds, NULL, NULL, &tv) <= 0) return 0;
+
+    int ready = 0;
+    if (FD_ISSET(s_listen_fd, &read_fds)) ready |= READY_LISTEN;
+    if (client_fd >= 0 && FD_ISSET(client_fd, &read_fds)) ready |= READY_CLIENT;
+    return ready;
+}
+
+static int wait_ready(int client_fd, uint32_t timeout_ms) {
+#if CONFIG_IDF_TARGET_LINUX
+    // The POSIX FreeRTOS port runs one task thread at a time, so a blocking
+    // select() would stall every other task; poll and yield instead
+    TickType_t start = xTaskGetTickCount();
+    do {
+        int ready = select_ready(client_fd, 0);
+        if (ready) return ready;
+        vTaskDelay(1);
+    } while (xTaskGetTickCount() - start < pdMS_TO_TICKS(timeout_ms));
+    return 0;
+#else
+    return select_ready(client_fd, timeout_ms);
+#endif
+}
+
+static void close_client(void) {
+    xSemaphoreTake(s_client_lock, portMAX_DELAY);
+    if (s_client_fd >= 0) {
+        close(s_client_fd);
+        s_client_fd = -1;
+    }
+    xSemaphoreGive(s_client_lock);
+}
+
+static esp_err_t tcp_open(void) {
+#if !CONFIG_IDF_TARGET_LINUX
+    // An unreachable access point is not fatal: the socket listens on any
+    // address and accepts as soon as the station gets one
+    esp_err_t ret = wifi_sta_connect(WIFI_CONNECT_TIMEOUT_MS);
+    if (ret == ESP_ERR_TIMEOUT) {
+        ESP_LOGW(TAG, "⚠️ Wi-Fi not connected yet, listening anyway");
+    } else if (ret != ESP_OK) {
+        return ret;
+    }
+#endif
+
+    s_client_lock = xSemaphoreCreateMutex();
+    if (!s_client_lock) return ESP_ERR_NO_MEM;
+
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        ESP_LOGE(TAG, "❌ Failed to create socket (errno %d)", errno);
+        return ESP_FAIL;
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_SLEEPSYNC_TCP_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 1) != 0) {
+        ESP_LOGE(TAG, "❌ Failed to listen on port %d (errno %d)", CONFIG_SLEEPSYNC_TCP_PORT, errno);
+        close(fd);
+        return ESP_FAIL;
+    }
+
+    s_listen_fd = fd;
+    ESP_LOGI(TAG, "🔌 Listening for protocol clients on TCP port %d", CONFIG_SLEEPSYNC_TCP_PORT);
+    return ESP_OK;
+}
+
+static int tcp_send(const void *data, size_t len) {
+    const char *bytes = data;
+    size_t sent = 0;
+    bool failed = false;
+
+    // One message per call: holding the lock keeps concurrent senders from
+    // interleaving on the socket
+    xSemaphoreTake(s_client_lock, portMAX_DELAY);
+    int fd = s_client_fd;
+    while (fd >= 0 && sent < len) {
+        int n = send(fd, bytes + sent, len - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            s_client_fd = -1;
+            failed = true;
+            break;
+        }
+        sent += n;
+    }
+    xSemaphoreGive(s_client_lock);
+
+    if (failed) return -1;
+    return (int)len;    // delivered, or discarded with nobody connected
+}
+
+static void accept_client(void) {
+    int fd = accept(s_listen_fd, NULL, NULL);
+    if (fd < 0) return;
+
+    // Protocol messages are small; don't let Nagle hold them back
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+#ifdef TCP_KEEPIDLE
+    int idle = KEEPALIVE_IDLE_S, interval = KEEPALIVE_INTERVAL_S, count = KEEPALIVE_COUNT;
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+    setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+#endif
+
+    xSemaphoreTake(s_client_lock, portMAX_DELAY);
+    bool replaced = s_client_fd >= 0;
+    if (replaced) close(s_client_fd);
+    s_client_fd = fd;
+    xSemaphoreGive(s_client_lock);
+
+    if (replaced) {
+        ESP_LOGI(TAG, "🔁 New protocol client replaced the previous one");
+    } else {
+        ESP_LOGI(TAG, "🌐 Protocol client connected");
+    }
+}
+
+static int tcp_recv(void *buf, size_t len, uint32_t timeout_ms) {
+    // The receiving task owns accept(); senders only ever close the client.
+    // The listen socket stays armed while connected so a new client can
+    // take over from one that disappeared silently.
+    int fd = s_client_fd;
+    int ready = wait_ready(fd, timeout_ms);
+    if (ready & READY_LISTEN) {
+        accept_client();
+        return 0;
+    }
+    if (!(ready & READY_CLIENT)) return 0;
+
+    int n = recv(fd, buf, len, 0);
+    if (n <= 0) {
+        ESP_LOGI(TAG, "🔌 Protocol client disconnected");
+        close_client();
+        return 0;
+    }
+    return n;
+}
+
+static esp_err_t tcp_flush(uint32_t timeout_ms) {
+    // send() hands everything to the stack before returning
+    return ESP_OK;
+}
+
+const transport_t transport_tcp = {
+    .name = "tcp",
+    .open = tcp_open,
+    .send = tcp_send,
+    .recv = tcp_recv,
+    .flush = tcp_flush,
+};
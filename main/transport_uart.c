@@ -0,0 +1,46 @@
+#include "freertos/FreeRTOS.h"
+#include "driver/uart.h"
+#include "sdkconfig.h"
+#include "transport.h"
+
+#define UART_PORT               CONFIG_SLEEPSYNC_UART_PORT
+#define UART_BUFFER_SIZE        1024
+
+static esp_err_t uart_link_open(void) {
+    uart_config_t uart_cfg = {
+        .baud_rate = CONFIG_SLEEPSYNC_UART_BAUD_RATE,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+    esp_err_t ret = uart_driver_install(UART_PORT, UART_BUFFER_SIZE, UART_BUFFER_SIZE, 0, NULL, 0);
+    if (ret != ESP_OK) return ret;
+
+    ret = uart_param_config(UART_PORT, &uart_cfg);
+    if (ret != ESP_OK) return ret;
+
+    return uart_set_pin(UART_PORT, CONFIG_SLEEPSYNC_UART_TX_PIN, CONFIG_SLEEPSYNC_UART_RX_PIN,
+                        UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+}
+
+static int uart_link_send(const void *data, size_t len) {
+    return uart_write_bytes(UART_PORT, data, len);
+}
+
+static int uart_link_recv(void *buf, size_t len, uint32_t timeout_ms) {
+    return uart_read_bytes(UART_PORT, buf, len, pdMS_TO_TICKS(timeout_ms));
+}
+
+static esp_err_t uart_link_flush(uint32_t timeout_ms) {
+    return uart_wait_tx_done(UART_PORT, pdMS_TO_TICKS(timeout_ms));
+}
+
+const transport_t transport_uart = {
+    .name = "uart",
+    .open = uart_link_open,
+    .send = uart_link_send,
+    .recv = uart_link_recv,
+    .flush = uart_link_flush,
+};
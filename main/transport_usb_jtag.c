@@ -0,0 +1,41 @@
+#include "freertos/FreeRTOS.h"
+#include "driver/usb_serial_jtag.h"
+#include "esp_vfs_dev.h"
+#include "transport.h"
+
+#define USB_JTAG_TX_BUFFER_SIZE     512
+#define USB_JTAG_RX_BUFFER_SIZE     512
+
+static esp_err_t usb_jtag_open(void) {
+    usb_serial_jtag_driver_config_t usb_cfg = {
+        .tx_buffer_size = USB_JTAG_TX_BUFFER_SIZE,
+        .rx_buffer_size = USB_JTAG_RX_BUFFER_SIZE,
+    };
+    esp_err_t ret = usb_serial_jtag_driver_install(&usb_cfg);
+    if (ret != ESP_OK) return ret;
+
+    // Route console output through the same driver so ESP_LOG lines and
+    // protocol messages do not fight over the FIFO
+    esp_vfs_usb_serial_jtag_use_driver(); // Note: deprecated but still functional
+    return ESP_OK;
+}
+
+static int usb_jtag_send(const void *data, size_t len) {
+    return usb_serial_jtag_write_bytes(data, len, portMAX_DELAY);
+}
+
+static int usb_jtag_recv(void *buf, size_t len, uint32_t timeout_ms) {
+    return usb_serial_jtag_read_bytes(buf, len, pdMS_TO_TICKS(timeout_ms));
+}
+
+static esp_err_t usb_jtag_flush(uint32_t timeout_ms) {
+    return usb_serial_jtag_wait_tx_done(pdMS_TO_TICKS(timeout_ms));
+}
+
+const transport_t transport_usb_jtag = {
+    .name = "usb_serial_jtag",
+    .open = usb_jtag_open,
+    .send = usb_jtag_send,
+    .recv = usb_jtag_recv,
+    .flush = usb_jtag_flush,
+};
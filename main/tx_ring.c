@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include "tx_ring.h"
+
+#define TX_RING_MASK    (TX_RING_CAPACITY - 1)
+
+_Static_assert((TX_RING_CAPACITY & TX_RING_MASK) == 0, "TX_RING_CAPACITY must be a power of two");
+_Static_assert(TX_RING_RESERVE < TX_RING_CAPACITY, "TX_RING_RESERVE must leave room for events");
+
+tx_msg_t *tx_msg_alloc(size_t len) {
+    tx_msg_t *msg = malloc(sizeof(tx_msg_t) + len);
+    if (msg) {
+        msg->len = len;
+        msg->origin_us = 0;
+    }
+    return msg;
+}
+
+void tx_ring_init(tx_ring_t *ring) {
+    for (uint32_t i = 0; i < TX_RING_CAPACITY; i++) {
+        atomic_init(&ring->slots[i].seq, i);
+        ring->slots[i].msg = NULL;
+    }
+    atomic_init(&ring->enqueue_pos, 0);
+    atomic_init(&ring->dequeue_pos, 0);
+    atomic_init(&ring->latest_sensor, NULL);
+    atomic_init(&ring->queued, 0);
+    atomic_init(&ring->dropped_critical, 0);
+    atomic_init(&ring->dropped_events, 0);
+    atomic_init(&ring->coalesced_sensor, 0);
+    atomic_init(&ring->dropped_logs, 0);
+}
+
+static uint32_t pending(tx_ring_t *ring) {
+    uint32_t enq = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+    uint32_t deq = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+    return enq - deq;
+}
+
+// Bounded MPMC enqueue (Vyukov): each slot's sequence number says whether
+// it is free for position pos, so producers only contend on enqueue_pos.
+static bool enqueue(tx_ring_t *ring, tx_msg_t *msg) {
+    uint32_t pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+    tx_slot_t *slot;
+
+    for (;;) {
+        slot = &ring->slots[pos & TX_RING_MASK];
+        uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            uint32_t expected = pos;
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueue_pos, &expected, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+            pos = expected;
+        } else if (diff < 0) {
+            return false;   // full
+        } else {
+            pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    slot->msg = msg;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+static _Atomic uint32_t *drop_counter(tx_ring_t *ring, tx_class_t cls) {
+    switch (cls) {
+    case TX_CLASS_EVENT: return &ring->dropped_events;
+    case TX_CLASS_LOG:   return &ring->dropped_logs;
+    default:             return &ring->dropped_critical;
+    }
+}
+
+bool tx_ring_push(tx_ring_t *ring, tx_msg_t *msg, tx_class_t cls) {
+    if (cls == TX_CLASS_SENSOR) {
+        tx_msg_t *stale = atomic_exchange_explicit(&ring->latest_sensor, msg, memory_order_acq_rel);
+        atomic_fetch_add_explicit(&ring->queued, 1, memory_order_relaxed);
+        if (stale) {
+            free(stale);
+            atomic_fetch_add_explicit(&ring->coalesced_sensor, 1, memory_order_relaxed);
+        }
+        return true;
+    }
+
+    uint32_t limit = TX_RING_CAPACITY;
+    if (cls == TX_CLASS_EVENT) limit = TX_RING_CAPACITY - TX_RING_RESERVE;
+    if (cls == TX_CLASS_LOG) limit = TX_RING_LOG_LIMIT;
+
+    if (pending(ring) >= limit || !enqueue(ring, msg)) {
+        free(msg);
+        atomic_fetch_add_explicit(drop_counter(ring, cls), 1, memory_order_relaxed);
+        return false;
+    }
+
+    atomic_fetch_add_explicit(&ring->queued, 1, memory_order_relaxed);
+    return true;
+}
+
+tx_msg_t *tx_ring_pop(tx_ring_t *ring) {
+    uint32_t pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+    tx_slot_t *slot = &ring->slots[pos & TX_RING_MASK];
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+    if (seq == pos + 1) {
+        tx_msg_t *msg = slot->msg;
+        slot->msg = NULL;
+        atomic_store_explicit(&ring->dequeue_pos, pos + 1, memory_order_relaxed);
+        // Hand the slot back to producers one lap ahead
+        atomic_store_explicit(&slot->seq, pos + TX_RING_CAPACITY, memory_order_release);
+        return msg;
+    }
+
+    return atomic_exchange_explicit(&ring->latest_sensor, NULL, memory_order_acq_rel);
+}
+
+void tx_ring_get_stats(tx_ring_t *ring, tx_ring_stats_t *stats) {
+    stats->queued = atomic_load_explicit(&ring->queued, memory_order_relaxed);
+    stats->dropped_critical = atomic_load_explicit(&ring->dropped_critical, memory_order_relaxed);
+    stats->dropped_events = atomic_load_explicit(&ring->dropped_events, memory_order_relaxed);
+    stats->coalesced_sensor = atomic_load_explicit(&ring->coalesced_sensor, memory_order_relaxed);
+    stats->dropped_logs = atomic_load_explicit(&ring->dropped_logs, memory_order_relaxed);
+    stats->pending = pending(ring);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- TX Ring ---
+// Lock-free multi-producer / single-consumer queue of outgoing protocol
+// messages. Producers never block: when the link stalls the ring fills up
+// and the drop policy below decides what survives.
+//
+//   TX_CLASS_CRITICAL  command responses, completions, status replies.
+//                      Dropped only when the ring is completely full.
+//   TX_CLASS_EVENT     unsolicited events (sound_event). Dropped once the
+//                      ring is within TX_RING_RESERVE slots of full, so
+//                      they can never crowd out critical messages.
+//   TX_CLASS_SENSOR    periodic sensor_data. Not queued at all: a single
+//                      "latest" slot is overwritten, so a stalled link
+//                      sees one fresh sample instead of a backlog.
+//   TX_CLASS_LOG       binary log frames. Shed once the ring is half full,
+//                      before any protocol message is at risk.
+//
+// Messages are heap-allocated tx_msg_t buffers (text or binary); the ring
+// takes ownership on push and frees whatever it drops. The module has no
+// FreeRTOS dependencies, so it also builds on the linux target.
+#define TX_RING_CAPACITY        32   // must be a power of two
+#define TX_RING_RESERVE         8    // slots only critical messages may use
+#define TX_RING_LOG_LIMIT       (TX_RING_CAPACITY / 2)
+
+typedef enum {
+    TX_CLASS_CRITICAL,
+    TX_CLASS_EVENT,
+    TX_CLASS_SENSOR,
+    TX_CLASS_LOG,
+} tx_class_t;
+
+typedef struct {
+    size_t len;
+    int64_t origin_us;      // command arrival time for a command response, else 0
+    uint8_t data[];
+} tx_msg_t;
+
+typedef struct {
+    _Atomic uint32_t seq;
+    tx_msg_t *msg;
+} tx_slot_t;
+
+typedef struct {
+    tx_slot_t slots[TX_RING_CAPACITY];
+    _Atomic uint32_t enqueue_pos;
+    _Atomic uint32_t dequeue_pos;
+    _Atomic(tx_msg_t *) latest_sensor;
+
+    _Atomic uint32_t queued;
+    _Atomic uint32_t dropped_critical;
+    _Atomic uint32_t dropped_events;
+    _Atomic uint32_t coalesced_sensor;
+    _Atomic uint32_t dropped_logs;
+} tx_ring_t;
+
+typedef struct {
+    uint32_t queued;             // messages accepted (sensor samples included)
+    uint32_t dropped_critical;   // critical messages lost to a full ring
+    uint32_t dropped_events;     // events shed to protect the reserve
+    uint32_t coalesced_sensor;   // sensor samples replaced before being sent
+    uint32_t dropped_logs;       // log frames shed under backpressure
+    uint32_t pending;            // messages currently waiting in the ring
+} tx_ring_stats_t;
+
+// Allocate a message with room for len bytes (msg->len is set to len).
+// Returns NULL when out of memory; release with free().
+tx_msg_t *tx_msg_alloc(size_t len);
+
+void tx_ring_init(tx_ring_t *ring);
+
+// Queue msg under cls. Always takes ownership; returns false if the message
+// was dropped (and freed) by the policy.
+bool tx_ring_push(tx_ring_t *ring, tx_msg_t *msg, tx_class_t cls);
+
+// Single consumer only. Returns the next message (caller frees), queued
+// messages first and the latest sensor sample last, or NULL when idle.
+tx_msg_t *tx_ring_pop(tx_ring_t *ring);
+
+void tx_ring_get_stats(tx_ring_t *ring, tx_ring_stats_t *stats);
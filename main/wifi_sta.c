@@ -0,0 +1,73 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_wifi.h"
+#include "sdkconfig.h"
+#include "wifi_sta.h"
+
+#define WIFI_CONNECTED_BIT      BIT0
+
+static const char *TAG = "WIFI_STA";
+
+static EventGroupHandle_t s_wifi_events;
+
+static void on_wifi_event(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    if (base == WIFI_EVENT && id == WIFI_EVENT_STA_START) {
+        esp_wifi_connect();
+    } else if (base == WIFI_EVENT && id == WIFI_EVENT_STA_DISCONNECTED) {
+        // The TCP listener stays open and accepts again once the address is back
+        xEventGroupClearBits(s_wifi_events, WIFI_CONNECTED_BIT);
+        ESP_LOGW(TAG, "⚠️ Wi-Fi disconnected, reconnecting...");
+        esp_wifi_connect();
+    } else if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
+        const ip_event_got_ip_t *event = data;
+        ESP_LOGI(TAG, "📶 Joined %s, IP " IPSTR, CONFIG_SLEEPSYNC_WIFI_SSID, IP2STR(&event->ip_info.ip));
+        xEventGroupSetBits(s_wifi_events, WIFI_CONNECTED_BIT);
+    }
+}
+
+esp_err_t wifi_sta_connect(uint32_t timeout_ms) {
+    if (strlen(CONFIG_SLEEPSYNC_WIFI_SSID) == 0) {
+        ESP_LOGE(TAG, "❌ No Wi-Fi SSID set (menuconfig -> SleepSync Firmware -> TCP transport)");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    s_wifi_events = xEventGroupCreate();
+    if (!s_wifi_events) return ESP_ERR_NO_MEM;
+
+    esp_err_t ret = esp_netif_init();
+    if (ret != ESP_OK) return ret;
+    ret = esp_event_loop_create_default();
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) return ret;
+    esp_netif_create_default_wifi_sta();
+
+    wifi_init_config_t init_config = WIFI_INIT_CONFIG_DEFAULT();
+    ret = esp_wifi_init(&init_config);
+    if (ret != ESP_OK) return ret;
+
+    ret = esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, on_wifi_event, NULL, NULL);
+    if (ret == ESP_OK) {
+        ret = esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, on_wifi_event, NULL, NULL);
+    }
+    if (ret != ESP_OK) return ret;
+
+    wifi_config_t wifi_config = {0};
+    strlcpy((char *)wifi_config.sta.ssid, CONFIG_SLEEPSYNC_WIFI_SSID, sizeof(wifi_config.sta.ssid));
+    strlcpy((char *)wifi_config.sta.password, CONFIG_SLEEPSYNC_WIFI_PASSWORD, sizeof(wifi_config.sta.password));
+
+    ret = esp_wifi_set_mode(WIFI_MODE_STA);
+    if (ret == ESP_OK) ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    if (ret == ESP_OK) ret = esp_wifi_start();
+    if (ret != ESP_OK) return ret;
+
+    // Modem sleep delays every received command by up to a beacon interval
+    esp_wifi_set_ps(WIFI_PS_NONE);
+
+    ESP_LOGI(TAG, "📶 Joining %s...", CONFIG_SLEEPSYNC_WIFI_SSID);
+    EventBits_t bits = xEventGroupWaitBits(s_wifi_events, WIFI_CONNECTED_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & WIFI_CONNECTED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
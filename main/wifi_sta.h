@@ -0,0 +1,12 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// --- Wi-Fi Station ---
+// Joins the network configured in menuconfig ("SleepSync Firmware" ->
+// "TCP transport") so the TCP transport has an interface to listen on.
+// Needs nvs_flash_init() first. Waits up to timeout_ms for an IP address and
+// returns ESP_ERR_TIMEOUT if none arrived; the station keeps reconnecting in
+// the background either way.
+esp_err_t wifi_sta_connect(uint32_t timeout_ms);
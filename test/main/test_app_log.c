@@ -0,0 +1,82 @@
+#include <string.h>
+#include "unity.h"
+#include "app_log.h"
+
+#define TIMESTAMP_MS    0x12345678
+
+// app_log_encode() takes a va_list, as app_log_write() passes it on
+static size_t encode(uint8_t *out, size_t cap, log_event_t event, ...) {
+    va_list args;
+    va_start(args, event);
+    size_t len = app_log_encode(out, cap, event, TIMESTAMP_MS, args);
+    va_end(args);
+    return len;
+}
+
+TEST_CASE("frame header carries marker, length, id and timestamp", "[app_log]") {
+    uint8_t frame[APP_LOG_MAX_FRAME];
+    const uint8_t expected[] = {
+        APP_LOG_FRAME_MARKER, 6,
+        LOG_EVT_EFFECTS_STOPPED, 0,
+        0x78, 0x56, 0x34, 0x12,
+    };
+
+    TEST_ASSERT_EQUAL(sizeof(expected), encode(frame, sizeof(frame), LOG_EVT_EFFECTS_STOPPED));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, frame, sizeof(expected));
+}
+
+TEST_CASE("int args are 4 bytes little endian", "[app_log]") {
+    uint8_t frame[APP_LOG_MAX_FRAME];
+    const uint8_t expected_args[] = {
+        0x03, 0x00, 0x00, 0x00,
+        0xFE, 0xFF, 0xFF, 0xFF,     // -2
+    };
+
+    TEST_ASSERT_EQUAL(8 + sizeof(expected_args), encode(frame, sizeof(frame), LOG_EVT_SUNRISE_STEP, 3, -2));
+    TEST_ASSERT_EQUAL_UINT8(6 + sizeof(expected_args), frame[1]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected_args, frame + 8, sizeof(expected_args));
+}
+
+TEST_CASE("string args are length-prefixed, uint args follow", "[app_log]") {
+    uint8_t frame[APP_LOG_MAX_FRAME];
+    const uint8_t expected_args[] = {
+        5, 'c', 'a', 'l', 'm', 'x',
+        0xF0, 0xFF, 0xFF, 0xFF,     // 0xFFFFFFF0u
+    };
+
+    TEST_ASSERT_EQUAL(8 + sizeof(expected_args),
+                      encode(frame, sizeof(frame), LOG_EVT_PROGRAM_STARTED, "calmx", 0xFFFFFFF0u));
+    TEST_ASSERT_EQUAL_UINT8(6 + sizeof(expected_args), frame[1]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected_args, frame + 8, sizeof(expected_args));
+}
+
+TEST_CASE("NULL string encodes as empty", "[app_log]") {
+    uint8_t frame[APP_LOG_MAX_FRAME];
+
+    TEST_ASSERT_EQUAL(9, encode(frame, sizeof(frame), LOG_EVT_PROCESSING_COMMAND, (const char *)NULL));
+    TEST_ASSERT_EQUAL_UINT8(7, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, frame[8]);
+}
+
+TEST_CASE("long strings are truncated to APP_LOG_MAX_FRAME", "[app_log]") {
+    uint8_t frame[APP_LOG_MAX_FRAME + 16];
+    char command[200];
+    memset(command, 'a', sizeof(command) - 1);
+    command[sizeof(command) - 1] = '\0';
+    memset(frame, 0xAA, sizeof(frame));
+
+    TEST_ASSERT_EQUAL(APP_LOG_MAX_FRAME,
+                      encode(frame, APP_LOG_MAX_FRAME, LOG_EVT_PROCESSING_COMMAND, command));
+    TEST_ASSERT_EQUAL_UINT8(APP_LOG_MAX_FRAME - 2, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(APP_LOG_MAX_FRAME - 9, frame[8]);
+    TEST_ASSERT_EQUAL_UINT8('a', frame[APP_LOG_MAX_FRAME - 1]);
+    TEST_ASSERT_EQUAL_UINT8(0xAA, frame[APP_LOG_MAX_FRAME]);   // nothing past the cap
+}
+
+TEST_CASE("invalid events and undersized buffers are rejected", "[app_log]") {
+    uint8_t frame[APP_LOG_MAX_FRAME];
+
+    TEST_ASSERT_EQUAL(0, encode(frame, sizeof(frame), LOG_EVT_COUNT));
+    TEST_ASSERT_EQUAL(0, encode(frame, sizeof(frame), (log_event_t)-1));
+    TEST_ASSERT_EQUAL(0, encode(frame, 7, LOG_EVT_EFFECTS_STOPPED));
+}
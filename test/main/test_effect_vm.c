@@ -0,0 +1,245 @@
+#include <string.h>
+#include "unity.h"
+#include "effect_vm.h"
+
+// Recording I/O hooks
+static int s_rgb_writes;
+static uint8_t s_rgb[3];
+static uint32_t s_tone_freq;
+static uint8_t s_tone_volume;
+static int s_tone_calls;
+static int32_t s_light;
+
+static void mock_set_rgb(uint8_t red, uint8_t green, uint8_t blue) {
+    s_rgb_writes++;
+    s_rgb[0] = red;
+    s_rgb[1] = green;
+    s_rgb[2] = blue;
+}
+
+static void mock_set_tone(uint32_t frequency, uint8_t volume) {
+    s_tone_calls++;
+    s_tone_freq = frequency;
+    s_tone_volume = volume;
+}
+
+static int32_t mock_read_sensor(effect_sensor_t sensor) {
+    return sensor == EFFECT_SENSOR_LIGHT ? s_light : 0;
+}
+
+static const effect_vm_io_t MOCK_IO = {
+    .set_rgb = mock_set_rgb,
+    .set_tone = mock_set_tone,
+    .read_sensor = mock_read_sensor,
+};
+
+static void start(effect_vm_t *vm, const uint8_t *code, size_t len) {
+    s_rgb_writes = 0;
+    memset(s_rgb, 0, sizeof(s_rgb));
+    s_tone_calls = 0;
+    s_tone_freq = 0;
+    s_tone_volume = 0;
+    TEST_ASSERT_TRUE(effect_vm_validate(code, len));
+    effect_vm_start(vm, code, len, &MOCK_IO);
+}
+
+// Tick every step_ms until the program stops; returns the final status
+static effect_vm_status_t run(effect_vm_t *vm, uint32_t step_ms, uint32_t limit_ms) {
+    effect_vm_status_t status = EFFECT_VM_RUNNING;
+    for (uint32_t now = 0; status == EFFECT_VM_RUNNING && now <= limit_ms; now += step_ms) {
+        status = effect_vm_tick(vm, now);
+    }
+    return status;
+}
+
+TEST_CASE("validate accepts well-formed programs", "[effect_vm]") {
+    const uint8_t nested[] = {
+        EFFECT_OP_LOOP, 2,
+        EFFECT_OP_LOOP, 3,
+        EFFECT_OP_RGB, 1, 2, 3,
+        EFFECT_OP_NEXT,
+        EFFECT_OP_NEXT,
+        EFFECT_OP_END,
+    };
+    TEST_ASSERT_TRUE(effect_vm_validate(nested, sizeof(nested)));
+
+    // Branches that stay inside their loop body: IF to the body's NEXT,
+    // JUMP back to the first body instruction
+    const uint8_t in_body[] = {
+        EFFECT_OP_LOOP, 0,
+        EFFECT_OP_WAIT, 10, 0,
+        EFFECT_OP_IF, EFFECT_SENSOR_LIGHT, EFFECT_CMP_GT, 0, 0, 3, 0,
+        EFFECT_OP_JUMP, 0xF3, 0xFF,     // -13: back to the WAIT
+        EFFECT_OP_NEXT,
+    };
+    TEST_ASSERT_TRUE(effect_vm_validate(in_body, sizeof(in_body)));
+
+    // IF skipping a whole loop stays at the top level
+    const uint8_t skip_loop[] = {
+        EFFECT_OP_IF, EFFECT_SENSOR_SOUND, EFFECT_CMP_EQ, 1, 0, 6, 0,
+        EFFECT_OP_LOOP, 2,
+        EFFECT_OP_WAIT, 1, 0,
+        EFFECT_OP_NEXT,
+        EFFECT_OP_END,
+    };
+    TEST_ASSERT_TRUE(effect_vm_validate(skip_loop, sizeof(skip_loop)));
+}
+
+TEST_CASE("validate rejects branches into or out of a loop body", "[effect_vm]") {
+    // JUMP from the body back onto its LOOP would push a new loop every pass
+    const uint8_t reenter_loop[] = {
+        EFFECT_OP_LOOP, 0,
+        EFFECT_OP_WAIT, 10, 0,
+        EFFECT_OP_JUMP, 0xF8, 0xFF,     // -8: onto the LOOP
+        EFFECT_OP_NEXT,
+    };
+    TEST_ASSERT_FALSE(effect_vm_validate(reenter_loop, sizeof(reenter_loop)));
+
+    const uint8_t leave_body[] = {
+        EFFECT_OP_LOOP, 2,
+        EFFECT_OP_JUMP, 1, 0,           // past the NEXT
+        EFFECT_OP_NEXT,
+        EFFECT_OP_END,
+    };
+    TEST_ASSERT_FALSE(effect_vm_validate(leave_body, sizeof(leave_body)));
+
+    const uint8_t enter_body[] = {
+        EFFECT_OP_IF, EFFECT_SENSOR_SOUND, EFFECT_CMP_EQ, 1, 0, 2, 0,   // onto the WAIT
+        EFFECT_OP_LOOP, 2,
+        EFFECT_OP_WAIT, 1, 0,
+        EFFECT_OP_NEXT,
+    };
+    TEST_ASSERT_FALSE(effect_vm_validate(enter_body, sizeof(enter_body)));
+
+    // Same depth, different loop
+    const uint8_t sibling_body[] = {
+        EFFECT_OP_LOOP, 2,
+        EFFECT_OP_WAIT, 1, 0,
+        EFFECT_OP_NEXT,
+        EFFECT_OP_LOOP, 2,
+        EFFECT_OP_JUMP, 0xF6, 0xFF,     // -10: into the first body
+        EFFECT_OP_NEXT,
+    };
+    TEST_ASSERT_FALSE(effect_vm_validate(sibling_body, sizeof(sibling_body)));
+}
+
+TEST_CASE("validate rejects malformed programs", "[effect_vm]") {
+    const uint8_t mid_instruction[] = {EFFECT_OP_RGB, 1, 2, 3, EFFECT_OP_JUMP, 0xFB, 0xFF};
+    const uint8_t unknown_op[] = {EFFECT_OP_RGB, 1, 2, 3, 0x42};
+    const uint8_t truncated[] = {EFFECT_OP_FADE, 1, 2, 3, 100};
+    const uint8_t open_loop[] = {EFFECT_OP_LOOP, 2, EFFECT_OP_WAIT, 1, 0};
+    const uint8_t stray_next[] = {EFFECT_OP_WAIT, 1, 0, EFFECT_OP_NEXT};
+    const uint8_t too_deep[] = {
+        EFFECT_OP_LOOP, 1, EFFECT_OP_LOOP, 1, EFFECT_OP_LOOP, 1, EFFECT_OP_LOOP, 1, EFFECT_OP_LOOP, 1,
+        EFFECT_OP_NEXT, EFFECT_OP_NEXT, EFFECT_OP_NEXT, EFFECT_OP_NEXT, EFFECT_OP_NEXT,
+    };
+    static uint8_t too_long[EFFECT_VM_MAX_PROGRAM + 1];
+
+    TEST_ASSERT_FALSE(effect_vm_validate(mid_instruction, sizeof(mid_instruction)));
+    TEST_ASSERT_FALSE(effect_vm_validate(unknown_op, sizeof(unknown_op)));
+    TEST_ASSERT_FALSE(effect_vm_validate(truncated, sizeof(truncated)));
+    TEST_ASSERT_FALSE(effect_vm_validate(open_loop, sizeof(open_loop)));
+    TEST_ASSERT_FALSE(effect_vm_validate(stray_next, sizeof(stray_next)));
+    TEST_ASSERT_FALSE(effect_vm_validate(too_deep, sizeof(too_deep)));
+    TEST_ASSERT_FALSE(effect_vm_validate(too_long, sizeof(too_long)));
+    TEST_ASSERT_FALSE(effect_vm_validate(too_long, 0));
+}
+
+TEST_CASE("loops run their body count times, nested loops multiply", "[effect_vm]") {
+    const uint8_t program[] = {
+        EFFECT_OP_LOOP, 2,
+        EFFECT_OP_LOOP, 3,
+        EFFECT_OP_RGB, 255, 0, 0,
+        EFFECT_OP_WAIT, 10, 0,
+        EFFECT_OP_RGB, 0, 0, 0,
+        EFFECT_OP_WAIT, 10, 0,
+        EFFECT_OP_NEXT,
+        EFFECT_OP_NEXT,
+        EFFECT_OP_RGB, 0, 0, 255,
+    };
+    effect_vm_t vm;
+    start(&vm, program, sizeof(program));
+
+    TEST_ASSERT_EQUAL(EFFECT_VM_DONE, run(&vm, 5, 1000));
+    TEST_ASSERT_EQUAL(2 * 3 * 2 + 1, s_rgb_writes);
+    TEST_ASSERT_EQUAL_UINT8(255, s_rgb[2]);
+}
+
+TEST_CASE("a forever loop without waits yields at the step budget", "[effect_vm]") {
+    const uint8_t program[] = {
+        EFFECT_OP_LOOP, 0,
+        EFFECT_OP_RGB, 1, 2, 3,
+        EFFECT_OP_NEXT,
+    };
+    effect_vm_t vm;
+    start(&vm, program, sizeof(program));
+
+    TEST_ASSERT_EQUAL(EFFECT_VM_RUNNING, effect_vm_tick(&vm, 0));
+    TEST_ASSERT_EQUAL(EFFECT_VM_RUNNING, effect_vm_tick(&vm, 20));
+    TEST_ASSERT_EQUAL(1, s_rgb_writes);     // repeated colour is not rewritten
+}
+
+TEST_CASE("fade interpolates linearly and lands on the target", "[effect_vm]") {
+    const uint8_t program[] = {
+        EFFECT_OP_FADE, 200, 100, 0, 100, 0,    // 100 ms from black
+        EFFECT_OP_END,
+    };
+    effect_vm_t vm;
+    start(&vm, program, sizeof(program));
+
+    TEST_ASSERT_EQUAL(EFFECT_VM_RUNNING, effect_vm_tick(&vm, 0));
+    TEST_ASSERT_EQUAL(0, s_rgb_writes);
+
+    effect_vm_tick(&vm, 25);
+    TEST_ASSERT_EQUAL_UINT8(50, s_rgb[0]);
+    TEST_ASSERT_EQUAL_UINT8(25, s_rgb[1]);
+
+    effect_vm_tick(&vm, 50);
+    TEST_ASSERT_EQUAL_UINT8(100, s_rgb[0]);
+    TEST_ASSERT_EQUAL_UINT8(50, s_rgb[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, s_rgb[2]);
+
+    // A late tick still ends on the exact keyframe
+    TEST_ASSERT_EQUAL(EFFECT_VM_DONE, effect_vm_tick(&vm, 130));
+    TEST_ASSERT_EQUAL_UINT8(200, s_rgb[0]);
+    TEST_ASSERT_EQUAL_UINT8(100, s_rgb[1]);
+}
+
+TEST_CASE("IF skips its block unless the condition holds", "[effect_vm]") {
+    const uint8_t program[] = {
+        EFFECT_OP_IF, EFFECT_SENSOR_LIGHT, EFFECT_CMP_GT, 0xE8, 0x03, 4, 0,    // light > 1000
+        EFFECT_OP_RGB, 255, 0, 0,
+        EFFECT_OP_RGB, 0, 0, 255,
+    };
+    effect_vm_t vm;
+
+    s_light = 500;
+    start(&vm, program, sizeof(program));
+    TEST_ASSERT_EQUAL(EFFECT_VM_DONE, effect_vm_tick(&vm, 0));
+    TEST_ASSERT_EQUAL(1, s_rgb_writes);
+    TEST_ASSERT_EQUAL_UINT8(255, s_rgb[2]);
+
+    s_light = 2000;
+    start(&vm, program, sizeof(program));
+    TEST_ASSERT_EQUAL(EFFECT_VM_DONE, effect_vm_tick(&vm, 0));
+    TEST_ASSERT_EQUAL(2, s_rgb_writes);
+}
+
+TEST_CASE("NOTE plays for its duration, then silences the buzzer", "[effect_vm]") {
+    const uint8_t program[] = {
+        EFFECT_OP_NOTE, 0xB8, 0x01, 100, 50, 0,     // 440 Hz, volume 100, 50 ms
+        EFFECT_OP_WAIT, 50, 0,
+    };
+    effect_vm_t vm;
+    start(&vm, program, sizeof(program));
+
+    effect_vm_tick(&vm, 0);
+    TEST_ASSERT_EQUAL_UINT32(440, s_tone_freq);
+    TEST_ASSERT_EQUAL_UINT8(100, s_tone_volume);
+
+    effect_vm_tick(&vm, 60);
+    TEST_ASSERT_EQUAL_UINT8(0, s_tone_volume);
+    TEST_ASSERT_EQUAL(2, s_tone_calls);
+
+    TEST_ASSERT_EQUAL(EFFECT_VM_DONE, effect_vm_tick(&vm, 100));
+}
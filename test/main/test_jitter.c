@@ -0,0 +1,94 @@
+#include "unity.h"
+#include "jitter.h"
+
+#define PERIOD_US   100000
+
+TEST_CASE("first mark only sets the reference point", "[jitter]") {
+    jitter_tracker_t t;
+    jitter_tracker_init(&t, PERIOD_US);
+
+    jitter_tracker_mark(&t, 5000000);
+    TEST_ASSERT_EQUAL_UINT32(0, t.samples);
+    TEST_ASSERT_EQUAL_INT64(5000000, t.last_us);
+
+    jitter_tracker_mark(&t, 5000000 + PERIOD_US);
+    TEST_ASSERT_EQUAL_UINT32(1, t.samples);
+    TEST_ASSERT_EQUAL_INT64(0, t.min_dev_us);
+    TEST_ASSERT_EQUAL_INT64(0, t.max_dev_us);
+}
+
+TEST_CASE("early and late wake-ups keep signed min/max", "[jitter]") {
+    jitter_tracker_t t;
+    jitter_tracker_init(&t, PERIOD_US);
+
+    int64_t now = 0;
+    jitter_tracker_mark(&t, now);
+    now += PERIOD_US + 300;     // late
+    jitter_tracker_mark(&t, now);
+    now += PERIOD_US - 120;     // early
+    jitter_tracker_mark(&t, now);
+    now += PERIOD_US + 40;      // late, but not the latest
+    jitter_tracker_mark(&t, now);
+
+    TEST_ASSERT_EQUAL_UINT32(3, t.samples);
+    TEST_ASSERT_EQUAL_INT64(-120, t.min_dev_us);
+    TEST_ASSERT_EQUAL_INT64(300, t.max_dev_us);
+}
+
+TEST_CASE("all-late samples keep a positive minimum", "[jitter]") {
+    jitter_tracker_t t;
+    jitter_tracker_init(&t, 0);
+
+    jitter_tracker_record(&t, 250);
+    jitter_tracker_record(&t, 900);
+    jitter_tracker_record(&t, 400);
+
+    TEST_ASSERT_EQUAL_INT64(250, t.min_dev_us);
+    TEST_ASSERT_EQUAL_INT64(900, t.max_dev_us);
+}
+
+TEST_CASE("mean_abs averages absolute deviations", "[jitter]") {
+    jitter_tracker_t t;
+    jitter_tracker_init(&t, 0);
+    TEST_ASSERT_EQUAL_INT64(0, jitter_tracker_mean_abs_us(&t));
+
+    jitter_tracker_record(&t, -300);
+    jitter_tracker_record(&t, 100);
+    jitter_tracker_record(&t, 200);
+
+    TEST_ASSERT_EQUAL_UINT64(600, t.sum_abs_us);
+    TEST_ASSERT_EQUAL_INT64(200, jitter_tracker_mean_abs_us(&t));
+}
+
+TEST_CASE("max_abs picks the larger magnitude of min and max", "[jitter]") {
+    jitter_tracker_t t;
+    jitter_tracker_init(&t, 0);
+    TEST_ASSERT_EQUAL_INT64(0, jitter_tracker_max_abs_us(&t));
+
+    jitter_tracker_record(&t, -750);
+    jitter_tracker_record(&t, 500);
+    TEST_ASSERT_EQUAL_INT64(750, jitter_tracker_max_abs_us(&t));
+
+    jitter_tracker_record(&t, 900);
+    TEST_ASSERT_EQUAL_INT64(900, jitter_tracker_max_abs_us(&t));
+}
+
+TEST_CASE("reset clears statistics but keeps the period", "[jitter]") {
+    jitter_tracker_t t;
+    jitter_tracker_init(&t, PERIOD_US);
+    jitter_tracker_mark(&t, 0);
+    jitter_tracker_mark(&t, PERIOD_US + 80);
+
+    jitter_tracker_reset(&t);
+
+    TEST_ASSERT_EQUAL_INT64(PERIOD_US, t.period_us);
+    TEST_ASSERT_EQUAL_UINT32(0, t.samples);
+    TEST_ASSERT_EQUAL_UINT64(0, t.sum_abs_us);
+    TEST_ASSERT_EQUAL_INT64(0, jitter_tracker_max_abs_us(&t));
+
+    // The next mark starts a new reference instead of measuring across the reset
+    jitter_tracker_mark(&t, 10 * PERIOD_US);
+    TEST_ASSERT_EQUAL_UINT32(0, t.samples);
+    jitter_tracker_mark(&t, 11 * PERIOD_US - 50);
+    TEST_ASSERT_EQUAL_INT64(-50, t.min_dev_us);
+}
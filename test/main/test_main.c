@@ -0,0 +1,9 @@
+#include <stdlib.h>
+#include "unity.h"
+
+void app_main(void) {
+    UNITY_BEGIN();
+    unity_run_all_tests();
+    // Exit status is the failure count, so CI can run the .elf directly
+    exit(UNITY_END());
+}
@@ -0,0 +1,138 @@
+#include <stdlib.h>
+#include "unity.h"
+#include "tx_ring.h"
+
+// One-byte message tagged with id, so pop order can be checked
+static tx_msg_t *msg(uint8_t id) {
+    tx_msg_t *m = tx_msg_alloc(1);
+    TEST_ASSERT_NOT_NULL(m);
+    m->data[0] = id;
+    return m;
+}
+
+// Pops the next message, checks its tag and frees it
+static void expect_pop(tx_ring_t *ring, uint8_t id) {
+    tx_msg_t *m = tx_ring_pop(ring);
+    TEST_ASSERT_NOT_NULL(m);
+    TEST_ASSERT_EQUAL_UINT8(id, m->data[0]);
+    free(m);
+}
+
+// Pushes cls until the first drop; returns how many were accepted
+static uint32_t fill(tx_ring_t *ring, tx_class_t cls, uint8_t first_id) {
+    uint32_t accepted = 0;
+    while (accepted <= TX_RING_CAPACITY && tx_ring_push(ring, msg(first_id + accepted), cls)) {
+        accepted++;
+    }
+    return accepted;
+}
+
+static void drain(tx_ring_t *ring) {
+    tx_msg_t *m;
+    while ((m = tx_ring_pop(ring)) != NULL) {
+        free(m);
+    }
+}
+
+TEST_CASE("messages pop in FIFO order across wrap-around", "[tx_ring]") {
+    static tx_ring_t ring;
+    tx_ring_init(&ring);
+    TEST_ASSERT_NULL(tx_ring_pop(&ring));
+
+    // Three laps, so slot sequence numbers are recycled
+    for (uint32_t i = 0; i < 3 * TX_RING_CAPACITY; i += 4) {
+        for (uint32_t j = 0; j < 4; j++) {
+            TEST_ASSERT_TRUE(tx_ring_push(&ring, msg((uint8_t)(i + j)), TX_CLASS_CRITICAL));
+        }
+        for (uint32_t j = 0; j < 4; j++) {
+            expect_pop(&ring, (uint8_t)(i + j));
+        }
+    }
+    TEST_ASSERT_NULL(tx_ring_pop(&ring));
+}
+
+TEST_CASE("events stop at the critical reserve", "[tx_ring]") {
+    static tx_ring_t ring;
+    tx_ring_init(&ring);
+
+    TEST_ASSERT_EQUAL_UINT32(TX_RING_CAPACITY - TX_RING_RESERVE, fill(&ring, TX_CLASS_EVENT, 0));
+
+    tx_ring_stats_t stats;
+    tx_ring_get_stats(&ring, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dropped_events);
+    TEST_ASSERT_EQUAL_UINT32(TX_RING_CAPACITY - TX_RING_RESERVE, stats.pending);
+
+    // The reserve is still open to critical messages
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(200), TX_CLASS_CRITICAL));
+    drain(&ring);
+}
+
+TEST_CASE("logs are shed once the ring is half full", "[tx_ring]") {
+    static tx_ring_t ring;
+    tx_ring_init(&ring);
+
+    TEST_ASSERT_EQUAL_UINT32(TX_RING_LOG_LIMIT, fill(&ring, TX_CLASS_LOG, 0));
+
+    // Events still fit above the log limit
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(100), TX_CLASS_EVENT));
+    TEST_ASSERT_FALSE(tx_ring_push(&ring, msg(101), TX_CLASS_LOG));
+
+    tx_ring_stats_t stats;
+    tx_ring_get_stats(&ring, &stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.dropped_logs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.dropped_events);
+    drain(&ring);
+}
+
+TEST_CASE("critical messages drop only when the ring is full", "[tx_ring]") {
+    static tx_ring_t ring;
+    tx_ring_init(&ring);
+
+    TEST_ASSERT_EQUAL_UINT32(TX_RING_CAPACITY, fill(&ring, TX_CLASS_CRITICAL, 0));
+
+    tx_ring_stats_t stats;
+    tx_ring_get_stats(&ring, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dropped_critical);
+    TEST_ASSERT_EQUAL_UINT32(TX_RING_CAPACITY, stats.queued);
+    TEST_ASSERT_EQUAL_UINT32(TX_RING_CAPACITY, stats.pending);
+
+    // One pop frees exactly one slot
+    expect_pop(&ring, 0);
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(99), TX_CLASS_CRITICAL));
+    TEST_ASSERT_FALSE(tx_ring_push(&ring, msg(98), TX_CLASS_CRITICAL));
+    drain(&ring);
+}
+
+TEST_CASE("sensor samples coalesce into the latest one", "[tx_ring]") {
+    static tx_ring_t ring;
+    tx_ring_init(&ring);
+
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(1), TX_CLASS_SENSOR));
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(2), TX_CLASS_SENSOR));
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(3), TX_CLASS_SENSOR));
+
+    tx_ring_stats_t stats;
+    tx_ring_get_stats(&ring, &stats);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.queued);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.coalesced_sensor);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.pending);
+
+    expect_pop(&ring, 3);
+    TEST_ASSERT_NULL(tx_ring_pop(&ring));
+}
+
+TEST_CASE("sensor sample pops after queued messages", "[tx_ring]") {
+    static tx_ring_t ring;
+    tx_ring_init(&ring);
+
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(1), TX_CLASS_CRITICAL));
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(50), TX_CLASS_SENSOR));
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(2), TX_CLASS_EVENT));
+    TEST_ASSERT_TRUE(tx_ring_push(&ring, msg(3), TX_CLASS_LOG));
+
+    expect_pop(&ring, 1);
+    expect_pop(&ring, 2);
+    expect_pop(&ring, 3);
+    expect_pop(&ring, 50);
+    TEST_ASSERT_NULL(tx_ring_pop(&ring));
+}